@@ -0,0 +1,37 @@
+#
+# Helpers for processing big trace files in parallel.
+#
+# A trace is split into byte chunks of similar sizes, aligned on line boundaries, which can be
+# read independently by several processes. This is shared by the trace post-processing scripts
+# of this directory, which find it next to them.
+#
+
+import os
+
+
+def get_chunks(path, nb_chunks):
+  # Split the file into chunks of similar sizes, starting at line boundaries
+  size = os.path.getsize(path)
+  bounds = [0]
+  with open(path, 'rb') as f:
+    for i in range(1, nb_chunks):
+      f.seek(max(size * i // nb_chunks, bounds[-1]))
+      f.readline()
+      bounds.append(f.tell())
+  bounds.append(size)
+
+  return [(start, end) for start, end in zip(bounds[:-1], bounds[1:]) if end > start]
+
+
+def read_chunk(path, start, end):
+  # Yield the lines of a chunk, skipping the trace header if it is the first one
+  with open(path, 'rb') as f:
+    f.seek(start)
+    if start == 0:
+      start += len(f.readline())
+    while start < end:
+      line = f.readline()
+      if len(line) == 0:
+        break
+      start += len(line)
+      yield line.decode('utf-8', errors='replace')
@@ -202,6 +202,11 @@ namespace vp
         // external event.
         int64_t stop_time = 0;
 
+        // Time at which the cycles were last updated from the time engine. Requests crossing
+        // into this domain often come in bursts at the same timestamp (interrupt, event or
+        // power lines), this allows skipping the update for all of them but the first one.
+        int64_t sync_time = -1;
+
         vp::Trace cycles_trace;
 
         vp::TimeEngine *time_engine = NULL;
@@ -90,7 +90,8 @@ inline vp::ClockEngine *vp::BlockClock::get_engine()
 
 inline void vp::ClockEngine::sync()
 {
-  if (!time.is_running() && this->permanent_first == NULL)
+  if (!time.is_running() && this->permanent_first == NULL &&
+    this->time.get_time() != this->sync_time)
   {
     this->update();
   }
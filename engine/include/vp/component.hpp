@@ -88,6 +88,7 @@ namespace vp
         friend class vp::Top;
         friend class vp::TimeEngine;
         friend class gv::GvsocLauncher;
+        friend js::Config *profiler_get_config(vp::Component &top, std::string section);
 
     public:
         /**
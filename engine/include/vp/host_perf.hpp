@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Host cycles, instructions, cache misses and branch misses
+#define HOST_PERF_NB_COUNTERS 4
+
+namespace gv {
+
+    /**
+     * @brief Host performance counters per simulation phase
+     *
+     * This reads the hardware performance counters of the workstation through perf_event_open
+     * around the phases of the simulation (loading, startup, run, proxy steps, etc), in order to
+     * know if a slowdown comes from cache misses, branch mispredictions or just more
+     * instructions.
+     * Counters only count the thread which opened them, so each thread entering a phase gets
+     * its own set of counters, opened the first time it enters a phase.
+     * If the counters are not available, for example due to perf_event_paranoid or when
+     * running in a container, a warning is printed once and only the wall-clock time is
+     * reported.
+     */
+    class HostPerf
+    {
+    public:
+        HostPerf();
+        ~HostPerf();
+
+        /**
+         * @brief Enter a phase
+         *
+         * Phases can not be nested within the same thread, entering a phase while another one
+         * is active first exits it.
+         *
+         * @param name Name of the phase. Counters of all instances of a phase are accumulated.
+         */
+        void phase_enter(std::string name);
+
+        /**
+         * @brief Exit the current phase of the calling thread
+         */
+        void phase_exit();
+
+        /**
+         * @brief Print the counters of all phases
+         */
+        void report(FILE *file);
+
+    private:
+        // Raw counter value, with the times during which it was enabled and really counting.
+        // They are all cumulative, so the scaling for multiplexing is applied to deltas.
+        class Sample
+        {
+        public:
+            uint64_t value;
+            uint64_t enabled;
+            uint64_t running;
+        };
+
+        // Counters of one thread
+        class Thread
+        {
+        public:
+            int fds[HOST_PERF_NB_COUNTERS];
+            std::string phase;
+            int64_t start_time;
+            Sample start[HOST_PERF_NB_COUNTERS];
+        };
+
+        // Accumulated counters of one phase
+        class Phase
+        {
+        public:
+            int64_t count;
+            int64_t duration;
+            uint64_t values[HOST_PERF_NB_COUNTERS];
+        };
+
+        Thread *get_thread();
+        void read_counters(Thread *thread, Sample *samples);
+        void close_thread(Thread *thread);
+        // Accumulate the counters of the current phase of the thread and leave it
+        void phase_close(Thread *thread);
+
+        std::mutex mutex;
+        std::map<std::thread::id, Thread> threads;
+        // Phases in order of first appearance, for reporting
+        std::vector<std::string> phase_names;
+        std::map<std::string, Phase> phases;
+        // True for each counter which could be opened at least once
+        bool available[HOST_PERF_NB_COUNTERS];
+        bool warned;
+    };
+
+};
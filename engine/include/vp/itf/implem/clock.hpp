@@ -24,10 +24,38 @@
 
 namespace vp {
 
+  inline bool ClockSignal::get_level(int64_t time)
+  {
+    int64_t first_edge = this->start_time + this->phase;
+    if (this->period == 0 || time < first_edge) return false;
+    return (time - first_edge) % this->period < this->get_high_time();
+  }
+
+  inline int64_t ClockSignal::get_next_edge(int64_t time)
+  {
+    if (this->period == 0) return -1;
+
+    int64_t first_edge = this->start_time + this->phase;
+    if (time < first_edge) return first_edge;
+
+    int64_t offset = (time - first_edge) % this->period;
+    int64_t cycle_start = time - offset;
+    if (offset < this->get_high_time()) return cycle_start + this->get_high_time();
+    return cycle_start + this->period;
+  }
+
+  inline int64_t ClockSignal::get_nb_cycles(int64_t time)
+  {
+    int64_t first_edge = this->start_time + this->phase;
+    if (this->period == 0 || time < first_edge) return 0;
+    return (time - first_edge) / this->period + 1;
+  }
+
   inline ClockMaster::ClockMaster()
   {
     this->sync_meth = &ClockMaster::sync_default;
     this->set_frequency_meth = &ClockMaster::set_frequency_default;
+    this->set_signal_meth = &ClockMaster::set_signal_default;
   }
 
   inline void ClockMaster::bind_to(vp::Port *_port, js::Config *config)
@@ -51,6 +79,8 @@ namespace vp {
       {
         sync_meth = port->sync;
         set_frequency_meth = port->set_frequency;
+        set_signal_meth = port->set_signal ? port->set_signal : &ClockMaster::set_signal_default;
+        has_sync = port->sync != &ClockMaster::sync_default;
         set_remote_context(port->get_context());
       }
       else
@@ -59,6 +89,12 @@ namespace vp {
         sync_meth = (void (*)(vp::Block *, bool))&ClockMaster::sync_muxed;
         set_frequency_meth_mux = port->set_frequency_mux;
         set_frequency_meth = (void (*)(vp::Block *, int64_t))&ClockMaster::set_frequency_muxed;
+        if (port->set_signal_mux)
+        {
+          set_signal_meth_mux = port->set_signal_mux;
+          set_signal_meth = (void (*)(vp::Block *, ClockSignal *))&ClockMaster::set_signal_muxed;
+        }
+        has_sync = true;
         set_remote_context(this);
         comp_mux = (vp::Component *)port->get_context();
         sync_mux = port->sync_mux_id;
@@ -75,6 +111,10 @@ namespace vp {
   {
   }
 
+  inline void ClockMaster::set_signal_default(vp::Block *, ClockSignal *signal)
+  {
+  }
+
   inline void ClockMaster::sync_muxed(ClockMaster *_this, bool value)
   {
     return _this->sync_meth_mux(_this->comp_mux, value, _this->sync_mux);
@@ -106,6 +146,29 @@ namespace vp {
     return _this->set_frequency_meth_mux(_this->comp_mux, frequency, _this->sync_mux);
   }
 
+  inline void ClockMaster::set_signal_freq_cross_stub(ClockMaster *_this, ClockSignal *signal)
+  {
+    if (_this->remote_port->get_owner()->clock.get_engine())
+      _this->remote_port->get_owner()->clock.get_engine()->sync();
+    return _this->set_signal_meth_freq_cross((Component *)_this->slave_context_for_freq_cross, signal);
+  }
+
+  inline void ClockMaster::set_signal_muxed(ClockMaster *_this, ClockSignal *signal)
+  {
+    return _this->set_signal_meth_mux(_this->comp_mux, signal, _this->sync_mux);
+  }
+
+  inline bool ClockMaster::needs_edges()
+  {
+    ClockMaster *port = this;
+    while(port)
+    {
+      if (port->has_sync) return true;
+      port = port->next;
+    }
+    return false;
+  }
+
   inline void ClockMaster::finalize()
   {
     ClockMaster *port = this;
@@ -124,6 +187,9 @@ namespace vp {
         port->set_frequency_meth_freq_cross = port->set_frequency_meth;
         port->set_frequency_meth = (void (*)(vp::Block *, int64_t))&ClockMaster::set_frequency_freq_cross_stub;
 
+        port->set_signal_meth_freq_cross = port->set_signal_meth;
+        port->set_signal_meth = (void (*)(vp::Block *, ClockSignal *))&ClockMaster::set_signal_freq_cross_stub;
+
         port->slave_context_for_freq_cross = (vp::Block *)port->get_remote_context();
         port->set_remote_context(port);
       }
@@ -171,10 +237,25 @@ namespace vp {
     sync_mux_id = id;
   }
 
-  inline ClockSlave::ClockSlave() : sync(NULL), sync_mux(NULL), set_frequency(NULL), set_frequency_mux(NULL)
+  inline void ClockSlave::set_set_signal_meth(void (*meth)(vp::Block *, ClockSignal *))
+  {
+    set_signal = meth;
+    set_signal_mux = NULL;
+  }
+
+  inline void ClockSlave::set_set_signal_meth_muxed(void (*meth)(vp::Block *, ClockSignal *, int), int id)
+  {
+    set_signal = NULL;
+    set_signal_mux = meth;
+    sync_mux_id = id;
+  }
+
+  inline ClockSlave::ClockSlave() : sync(NULL), sync_mux(NULL), set_frequency(NULL), set_frequency_mux(NULL),
+    set_signal(NULL), set_signal_mux(NULL)
   {
     this->sync = &ClockMaster::sync_default;
     this->set_frequency = &ClockMaster::set_frequency_default;
+    this->set_signal = &ClockMaster::set_signal_default;
   }
 
   inline void vp::ClkMaster::bind_to(vp::Port *_port, js::Config *config)
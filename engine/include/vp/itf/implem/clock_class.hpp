@@ -30,6 +30,38 @@ namespace vp {
 
   class ClockSlave;
 
+  /**
+   * @brief Analytical description of a clock signal
+   *
+   * This can be sent instead of one sync call per edge, each time the clock is modified, so that
+   * the receiver can compute the edges on demand instead of getting one event per edge.
+   * Rising edges happen at start_time + phase + N*period, and the clock stays high during
+   * duty percent of the period.
+   */
+  class ClockSignal
+  {
+  public:
+    // Clock period in picoseconds, 0 if the clock is stopped
+    int64_t period;
+    // Delay in picoseconds from the start time to the first rising edge
+    int64_t phase;
+    // Percentage of the period during which the clock is high
+    int duty;
+    // Time in picoseconds from which the edges are computed
+    int64_t start_time;
+
+    // Return the clock level at the specified time
+    inline bool get_level(int64_t time);
+    // Return the time of the first edge strictly after the specified time, or -1 if the clock
+    // is stopped
+    inline int64_t get_next_edge(int64_t time);
+    // Return the number of rising edges since the start time, up to the specified time included
+    inline int64_t get_nb_cycles(int64_t time);
+
+  private:
+    inline int64_t get_high_time() { return this->period * this->duty / 100; }
+  };
+
   class ClockMaster : public MasterPort
   {
     friend class ClockSlave;
@@ -49,10 +81,21 @@ namespace vp {
       set_frequency_meth((vp::Block *)this->get_remote_context(), frequency);
     }
 
+    inline void set_signal(ClockSignal *signal)
+    {
+      if (next) next->set_signal(signal);
+      set_signal_meth((vp::Block *)this->get_remote_context(), signal);
+    }
+
     void bind_to(vp::Port *port, js::Config *config);
 
     bool is_bound() { return SlavePort != NULL; }
 
+    // Tell if at least one of the bound slaves registered a sync method and thus needs a call on
+    // each edge. Slaves keeping the default one do not, whether they use the signal description
+    // or not, and the master can then skip generating the edges.
+    inline bool needs_edges();
+
     void finalize();
 
   private:
@@ -64,6 +107,10 @@ namespace vp {
     static inline void set_frequency_default(vp::Block *, int64_t value);
     static inline void set_frequency_freq_cross_stub(ClockMaster *_this, int64_t value);
 
+    static inline void set_signal_muxed(ClockMaster *_this, ClockSignal *signal);
+    static inline void set_signal_default(vp::Block *, ClockSignal *signal);
+    static inline void set_signal_freq_cross_stub(ClockMaster *_this, ClockSignal *signal);
+
     void (*sync_meth)(vp::Block *, bool value);
     void (*sync_meth_mux)(vp::Block *, bool value, int id);
     void (*sync_meth_freq_cross)(vp::Block *, bool value);
@@ -72,6 +119,12 @@ namespace vp {
     void (*set_frequency_meth_mux)(vp::Block *, int64_t frequency, int id);
     void (*set_frequency_meth_freq_cross)(vp::Block *, int64_t value);
 
+    void (*set_signal_meth)(vp::Block *, ClockSignal *signal);
+    void (*set_signal_meth_mux)(vp::Block *, ClockSignal *signal, int id);
+    void (*set_signal_meth_freq_cross)(vp::Block *, ClockSignal *signal);
+
+    // True if the slave registered a sync method and thus needs all edges
+    bool has_sync = false;
     vp::Component *comp_mux;
     int sync_mux;
     ClockSlave *SlavePort = NULL;
@@ -96,6 +149,9 @@ namespace vp {
     void set_set_frequency_meth(void (*)(vp::Block *_this, int64_t frequency));
     void set_set_frequency_meth_muxed(void (*)(vp::Block *_this, int64_t, int), int id);
 
+    void set_set_signal_meth(void (*)(vp::Block *_this, ClockSignal *signal));
+    void set_set_signal_meth_muxed(void (*)(vp::Block *_this, ClockSignal *signal, int), int id);
+
     inline void bind_to(vp::Port *_port, js::Config *config);
 
 
@@ -107,6 +163,9 @@ namespace vp {
     void (*set_frequency)(vp::Block *comp, int64_t frequency);
     void (*set_frequency_mux)(vp::Block *comp, int64_t frequency, int id);
 
+    void (*set_signal)(vp::Block *comp, ClockSignal *signal);
+    void (*set_signal_mux)(vp::Block *comp, ClockSignal *signal, int id);
+
     int sync_mux_id;
   };
 
@@ -86,9 +86,12 @@ namespace vp {
     // The normal callback was tweaked in order to get there when the master is sending a
     // request. 
     // First synchronize the target engine in case it was left behind,
-    // and then generate the normal call with the mux ID using the saved handler
-    if ( _this->remote_port->get_owner()->clock.get_engine())
-      _this->remote_port->get_owner()->clock.get_engine()->sync();
+    // and then generate the normal call with the mux ID using the saved handler.
+    // The call is still delivered immediately to keep the ordering with other requests, but
+    // the engine skips the synchronization if it is running or already synchronized at the
+    // current timestamp.
+    if (_this->engine_for_freq_cross)
+      _this->engine_for_freq_cross->sync();
     return _this->sync_meth_freq_cross((Component *)_this->slave_context_for_freq_cross, value);
   }
 
@@ -99,7 +102,8 @@ namespace vp {
     // request. 
     // First synchronize the target engine in case it was left behind,
     // and then generate the normal call with the mux ID using the saved handler
-    _this->remote_port->get_owner()->clock.get_engine()->sync();
+    if (_this->engine_for_freq_cross)
+      _this->engine_for_freq_cross->sync();
     return _this->sync_back_meth_freq_cross((Component *)_this->slave_context_for_freq_cross, value);
   }
 
@@ -119,6 +123,7 @@ namespace vp {
       this->sync_back_meth = (void (*)(vp::Block *, T *))&WireMaster<T>::sync_back_freq_cross_stub;
 
       this->slave_context_for_freq_cross = (vp::Block *)this->get_remote_context();
+      this->engine_for_freq_cross = this->remote_port->get_owner()->clock.get_engine();
       this->set_remote_context(this);
     }
   }
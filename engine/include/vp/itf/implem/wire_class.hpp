@@ -87,6 +87,8 @@ namespace vp {
     WireMaster<T> *next = NULL;
 
     vp::Block *slave_context_for_freq_cross;
+    // Clock engine of the slave, resolved once when the binding is crossing domains
+    vp::ClockEngine *engine_for_freq_cross;
 
     int master_sync_mux_id;
   };
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <vp/vp.hpp>
+#include <vp/host_perf.hpp>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -106,6 +107,8 @@ class GvsocLauncher : public gv::Gvsoc
         GvProxy *proxy;
         bool running = false;
         bool run_req = false;
+        // Host performance counters, NULL if not enabled
+        HostPerf *host_perf = NULL;
     };
 
 };
\ No newline at end of file
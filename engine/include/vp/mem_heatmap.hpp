@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vp/vp.hpp>
+#include <vp/component.hpp>
+
+// Magic number at the beginning of heatmap files
+#define MEM_HEATMAP_MAGIC "GVHEATM1"
+
+namespace vp {
+
+    /**
+     * @brief Memory access heatmap
+     *
+     * This counts reads and writes per block of memory, so that hot areas can be identified
+     * when tuning data placement.
+     * Counters are two arrays of saturating 32-bit counters, one entry per block, so that
+     * accounting is a shift and an increment.
+     * The heatmap is enabled globally from the gvsoc options (mem_heatmap/enabled,
+     * mem_heatmap/block_size in bytes, power of 2, and mem_heatmap/path for the output directory)
+     * and each owner dumps to a file named after its component path.
+     * The files can be merged and mapped to ELF symbols with the gvsoc_heatmap tool.
+     *
+     * File format, with all fields little-endian:
+     * - header: 8 bytes magic, uint64 base address, uint64 size, uint32 block size, uint32 number
+     *   of blocks.
+     * - uint32 read counters, one per block.
+     * - uint32 write counters, one per block.
+     */
+    class MemHeatmap
+    {
+    public:
+        /**
+         * @brief Construct a new heatmap
+         *
+         * @param top  Component owning the heatmap. Its path is used for naming the output file.
+         * @param name Optional suffix added to the file name, to have several heatmaps in the
+         *     same component.
+         */
+        MemHeatmap(vp::Component &top, std::string name="");
+        ~MemHeatmap();
+
+        /**
+         * @brief Allocate counters for the specified area
+         *
+         * This does nothing if the heatmap is not enabled.
+         *
+         * @param base Address of the area. This is only reported in the file, accesses are
+         *     accounted with offsets from the beginning of the area.
+         * @param size Size in bytes of the area.
+         */
+        void init(uint64_t base, uint64_t size);
+
+        /**
+         * @brief Tell if the heatmap is enabled
+         *
+         * Accounting should only be done when it returns true.
+         */
+        inline bool get_active() { return this->active; }
+
+        /**
+         * @brief Account an access
+         *
+         * @param offset   Offset of the access from the beginning of the area.
+         * @param size     Size in bytes of the access.
+         * @param is_write True if the access is a write.
+         */
+        inline void account(uint64_t offset, uint64_t size, bool is_write);
+
+        /**
+         * @brief Write the counters to the file
+         *
+         * This should be called when the simulation is over, usually from the stop method of the
+         * owning component.
+         */
+        void dump();
+
+    private:
+        vp::Component &top;
+        vp::Trace trace;
+        std::string name;
+        // Path of the output file
+        std::string path;
+        bool active;
+        uint64_t base;
+        uint64_t size;
+        // Log2 of the block size
+        int block_shift;
+        uint64_t nb_blocks;
+        uint32_t *reads;
+        uint32_t *writes;
+    };
+};
+
+
+inline void vp::MemHeatmap::account(uint64_t offset, uint64_t size, bool is_write)
+{
+    uint32_t *counters = is_write ? this->writes : this->reads;
+    uint64_t first = offset >> this->block_shift;
+    uint64_t last = (offset + size - 1) >> this->block_shift;
+
+    if (last >= this->nb_blocks)
+    {
+        last = this->nb_blocks - 1;
+    }
+
+    for (uint64_t block = first; block <= last; block++)
+    {
+        // Saturate instead of wrapping so that very hot blocks stay on top
+        if (counters[block] != UINT32_MAX)
+        {
+            counters[block]++;
+        }
+    }
+}
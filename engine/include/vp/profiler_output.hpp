@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vp/vp.hpp>
+#include <vp/component.hpp>
+
+/*
+ * Helpers for the profiling features dumping one file per component, like the traffic profiler
+ * and the memory heatmap.
+ * Each feature is enabled globally from a section of the gvsoc options, with an enabled flag
+ * and the output directory in path, and dumps to a file named after the component path.
+ */
+
+namespace vp {
+
+    /**
+     * @brief Return the options of a profiling feature
+     *
+     * @param top     Component using the feature.
+     * @param section Name of the section in the gvsoc options, e.g. traffic_profiler.
+     * @return The section, or NULL if the feature is not enabled.
+     */
+    js::Config *profiler_get_config(vp::Component &top, std::string section);
+
+    /**
+     * @brief Return the output file path of a profiling feature
+     *
+     * The file is named after the component path, e.g. chip.soc.l2.heatmap for /chip/soc/l2,
+     * in the directory given by the path option, or the current directory.
+     *
+     * @param top       Component using the feature.
+     * @param config    Options of the feature, as returned by profiler_get_config.
+     * @param name      Optional suffix added to the file name, to have several files in the
+     *     same component.
+     * @param extension Extension of the file, without the dot.
+     */
+    std::string profiler_get_path(vp::Component &top, js::Config *config, std::string name,
+        std::string extension);
+
+    /**
+     * @brief Open the output file of a profiling feature for writing
+     *
+     * The directory is created if needed. Errors are reported as warnings.
+     *
+     * @param trace Trace used for reporting errors.
+     * @param path  Path of the file, as returned by profiler_get_path.
+     * @param kind  Name of the feature, used in messages.
+     * @return The file, or NULL if it could not be opened.
+     */
+    FILE *profiler_open_file(vp::Trace *trace, std::string path, std::string kind);
+};
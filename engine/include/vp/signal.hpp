@@ -21,6 +21,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
 #include <sstream>
 
 namespace vp {
@@ -41,7 +42,15 @@ namespace vp {
         }
 
     protected:
-        virtual void reset(bool active) {};
+        // The reset value is restored by copying it from the reset image of the signal, so that
+        // the block can reset all its signals without any virtual call.
+        inline void reset(bool active)
+        {
+            if (active)
+            {
+                memcpy(this->value_bytes, this->reset_value_bytes, this->value_size);
+            }
+        }
 
         std::string name = "";
         vp::Trace trace;
@@ -49,6 +58,8 @@ namespace vp {
         int width;
         bool do_reset;
         int nb_bytes;
+        // Size in bytes of the value storage, can be bigger than nb_bytes
+        int value_size;
         uint8_t *value_bytes;
         uint8_t *reset_value_bytes;
     };
@@ -62,8 +73,6 @@ namespace vp {
         inline T get();
         inline void inc(T value);
         inline void dec(T value);
-    protected:
-        void reset(bool active) override;
     private:
         T value;
         T reset_value;
@@ -96,22 +105,11 @@ vp::Signal<T>::Signal(vp::Block &parent, std::string name, int width, bool do_re
     : SignalCommon(parent, name, width, do_reset)
 {
     this->reset_value = reset;
+    this->value_size = sizeof(T);
     this->value_bytes = (uint8_t *)&this->value;
     this->reset_value_bytes = (uint8_t *)&this->reset_value;
 }
 
-template<class T>
-void vp::Signal<T>::reset(bool active)
-{
-    if (active)
-    {
-        std::ostringstream value;
-        // value << std::hex << this->value;
-        // this->trace.msg(vp::Trace::LEVEL_TRACE, "Resetting signal (value: %s)\n", value.str().c_str());
-        this->value = this->reset_value;
-    }
-}
-
 template<class T>
 inline void vp::Signal<T>::inc(T value)
 {
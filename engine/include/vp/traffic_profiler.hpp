@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <vp/vp.hpp>
+#include <vp/component.hpp>
+
+// Magic number at the beginning of traffic profile files
+#define TRAFFIC_PROFILER_MAGIC "GVTRAFF1"
+// Number of records kept in memory before they are written to the file
+#define TRAFFIC_PROFILER_BUFFER_SIZE 4096
+
+namespace vp {
+
+    class Component;
+
+    /**
+     * @brief Time-series traffic profiler
+     *
+     * This can be used by interconnect and memory models to get a profile of the traffic going
+     * through them over time, which is much cheaper than analyzing traces or VCD events.
+     * Bytes, number of requests and stall cycles are accumulated per channel (e.g. a router
+     * target or a memory bank) into bins of fixed simulated time.
+     * Each time a bin is over, the non-empty channels are appended to a buffer which is
+     * regularly written to a binary file, so that the memory footprint does not depend on the
+     * simulation duration.
+     * The profiler is enabled globally from the gvsoc options (traffic_profiler/enabled,
+     * traffic_profiler/bin_size in picoseconds and traffic_profiler/path for the output
+     * directory) and each component dumps to a file named after its path.
+     * The files can be aggregated with the gvsoc_traffic tool.
+     *
+     * File format, with all fields little-endian:
+     * - header: 8 bytes magic, uint64 bin size in ps, uint32 number of channels, then for each
+     *   channel an uint32 name length followed by the name.
+     * - records until the end of the file: int64 bin index, uint64 read bytes, uint64 write
+     *   bytes, uint64 stall cycles, uint32 channel, uint32 reads, uint32 writes, uint32 unused.
+     */
+    class TrafficProfiler
+    {
+    public:
+        /**
+         * @brief Construct a new traffic profiler
+         *
+         * @param top Component owning the profiler. Its path is used for naming the output file
+         *     and its time for selecting the bin.
+         */
+        TrafficProfiler(vp::Component &top);
+        ~TrafficProfiler();
+
+        /**
+         * @brief Declare a new channel
+         *
+         * Channels should be declared before the simulation starts, as their names are dumped
+         * in the file header when the first records are written.
+         *
+         * @param name Name of the channel, as displayed by the analysis tool.
+         * @return The channel identifier to be given when accounting traffic.
+         */
+        int add_channel(std::string name);
+
+        /**
+         * @brief Tell if the profiler is enabled
+         *
+         * Accounting should only be done when it returns true.
+         */
+        inline bool get_active() { return this->active; }
+
+        /**
+         * @brief Account a request into the current bin
+         *
+         * @param channel  Channel identifier returned by add_channel.
+         * @param is_write True if the request is a write.
+         * @param bytes    Size in bytes of the request.
+         * @param stalls   Number of cycles the request was stalled due to contention.
+         */
+        inline void account(int channel, bool is_write, uint64_t bytes, int64_t stalls);
+
+        /**
+         * @brief Write all pending bins to the file and close it
+         *
+         * This should be called when the simulation is over, usually from the stop method of the
+         * owning component.
+         */
+        void dump();
+
+    private:
+        // Statistics of one channel in the current bin
+        class Bin
+        {
+        public:
+            uint64_t read_bytes;
+            uint64_t write_bytes;
+            uint64_t stalls;
+            uint32_t nb_reads;
+            uint32_t nb_writes;
+        };
+
+        // Record as written to the file
+        class Record
+        {
+        public:
+            int64_t bin;
+            uint64_t read_bytes;
+            uint64_t write_bytes;
+            uint64_t stalls;
+            uint32_t channel;
+            uint32_t nb_reads;
+            uint32_t nb_writes;
+            uint32_t unused;
+        };
+
+        // Close the current bin and move to the specified one
+        void switch_bin(int64_t bin);
+        // Write buffered records to the file, opening it if needed
+        void write_records();
+        // Open the output file and write the header
+        bool open_file();
+
+        vp::Component &top;
+        vp::Trace trace;
+        bool active;
+        // Size in picoseconds of a bin
+        int64_t bin_size;
+        // Index of the bin being accumulated, -1 if none
+        int64_t current_bin;
+        std::vector<std::string> channel_names;
+        std::vector<Bin> bins;
+        std::vector<Record> records;
+        std::string path;
+        FILE *file;
+    };
+};
+
+
+inline void vp::TrafficProfiler::account(int channel, bool is_write, uint64_t bytes,
+    int64_t stalls)
+{
+    int64_t bin = this->top.time.get_time() / this->bin_size;
+    if (bin != this->current_bin)
+    {
+        this->switch_bin(bin);
+    }
+
+    Bin *stats = &this->bins[channel];
+    if (is_write)
+    {
+        stats->write_bytes += bytes;
+        stats->nb_writes++;
+    }
+    else
+    {
+        stats->read_bytes += bytes;
+        stats->nb_reads++;
+    }
+    if (stalls > 0)
+    {
+        stats->stalls += stalls;
+    }
+}
@@ -100,21 +100,26 @@ void vp::Block::reset_all(bool active, bool from_itf)
             object->reset(active);
         }
 
-        for (SignalCommon *signal: this->signals)
+        // Signals, registers and events only have something to do when the reset is asserted
+        if (active)
         {
-            signal->reset(active);
-        }
+            for (SignalCommon *signal: this->signals)
+            {
+                signal->reset(active);
+            }
 
-        for (RegisterCommon *reg: this->registers)
-        {
-            reg->reset(active);
-        }
+            for (RegisterCommon *reg: this->registers)
+            {
+                reg->reset(active);
+            }
 
-        if (active)
-        {
             for (ClockEvent *event: this->clock.events)
             {
-                this->event_cancel(event);
+                // Check it here to avoid going through the clock engine for idle events
+                if (event->is_enqueued())
+                {
+                    this->event_cancel(event);
+                }
             }
         }
 
@@ -232,6 +232,8 @@ void vp::ClockEngine::apply_frequency(int64_t frequency)
 
 void vp::ClockEngine::update()
 {
+    this->sync_time = this->time.get_time();
+
     if (this->period == 0)
     {
         this->stop_time = this->time.get_time();
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <vp/host_perf.hpp>
+
+
+static const uint64_t host_perf_configs[HOST_PERF_NB_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+static const char *host_perf_names[HOST_PERF_NB_COUNTERS] = {
+    "cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+
+static int64_t host_perf_get_time()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+
+
+gv::HostPerf::HostPerf()
+    : warned(false)
+{
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        this->available[i] = false;
+    }
+}
+
+
+
+gv::HostPerf::~HostPerf()
+{
+    for (auto &thread: this->threads)
+    {
+        this->close_thread(&thread.second);
+    }
+}
+
+
+
+gv::HostPerf::Thread *gv::HostPerf::get_thread()
+{
+    std::thread::id id = std::this_thread::get_id();
+    auto it = this->threads.find(id);
+    if (it != this->threads.end())
+    {
+        return &it->second;
+    }
+
+    Thread *thread = &this->threads[id];
+    thread->phase = "";
+    int error = 0;
+
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = host_perf_configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Counters may be multiplexed if the host does not have enough of them, in which case
+        // values are scaled using enabled and running times
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Only count the calling thread, on any CPU
+        thread->fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (thread->fds[i] < 0)
+        {
+            error = errno;
+        }
+        else
+        {
+            this->available[i] = true;
+        }
+    }
+
+    if (error != 0 && !this->warned)
+    {
+        this->warned = true;
+        fprintf(stderr, "WARNING: Some host performance counters are not available, they will "
+            "not be reported (error: %s). Check /proc/sys/kernel/perf_event_paranoid.\n",
+            strerror(error));
+    }
+
+    return thread;
+}
+
+
+
+void gv::HostPerf::close_thread(Thread *thread)
+{
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        if (thread->fds[i] >= 0)
+        {
+            close(thread->fds[i]);
+            thread->fds[i] = -1;
+        }
+    }
+}
+
+
+
+void gv::HostPerf::read_counters(Thread *thread, Sample *samples)
+{
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        // Value, time enabled and time running
+        uint64_t data[3];
+        samples[i] = {};
+
+        if (thread->fds[i] >= 0 && read(thread->fds[i], data, sizeof(data)) == sizeof(data))
+        {
+            samples[i] = { data[0], data[1], data[2] };
+        }
+    }
+}
+
+
+
+void gv::HostPerf::phase_enter(std::string name)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    Thread *thread = this->get_thread();
+
+    if (thread->phase != "")
+    {
+        this->phase_close(thread);
+    }
+
+    if (this->phases.find(name) == this->phases.end())
+    {
+        this->phase_names.push_back(name);
+        this->phases[name] = {};
+    }
+
+    thread->phase = name;
+    thread->start_time = host_perf_get_time();
+    this->read_counters(thread, thread->start);
+}
+
+
+
+void gv::HostPerf::phase_exit()
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    Thread *thread = this->get_thread();
+    if (thread->phase != "")
+    {
+        this->phase_close(thread);
+    }
+}
+
+
+
+void gv::HostPerf::phase_close(Thread *thread)
+{
+    Sample samples[HOST_PERF_NB_COUNTERS];
+    this->read_counters(thread, samples);
+
+    Phase *phase = &this->phases[thread->phase];
+    phase->count++;
+    phase->duration += host_perf_get_time() - thread->start_time;
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        uint64_t value = samples[i].value - thread->start[i].value;
+        uint64_t enabled = samples[i].enabled - thread->start[i].enabled;
+        uint64_t running = samples[i].running - thread->start[i].running;
+
+        // If the counter was multiplexed during the phase, extrapolate it to the whole phase
+        if (running != 0 && running < enabled)
+        {
+            value = (uint64_t)((double)value * enabled / running);
+        }
+
+        phase->values[i] += value;
+    }
+
+    thread->phase = "";
+}
+
+
+
+void gv::HostPerf::report(FILE *file)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    fprintf(file, "Host performance counters:\n");
+    fprintf(file, "%-12s %8s %12s", "Phase", "Count", "Time (ms)");
+    for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+    {
+        fprintf(file, " %16s", host_perf_names[i]);
+    }
+    fprintf(file, " %8s\n", "IPC");
+
+    for (std::string &name: this->phase_names)
+    {
+        Phase *phase = &this->phases[name];
+        fprintf(file, "%-12s %8" PRId64 " %12.3f", name.c_str(), phase->count,
+            (double)phase->duration / 1000000);
+
+        for (int i=0; i<HOST_PERF_NB_COUNTERS; i++)
+        {
+            if (this->available[i])
+            {
+                fprintf(file, " %16" PRIu64, phase->values[i]);
+            }
+            else
+            {
+                fprintf(file, " %16s", "n/a");
+            }
+        }
+
+        if (this->available[0] && this->available[1] && phase->values[0] != 0)
+        {
+            fprintf(file, " %8.3f\n", (double)phase->values[1] / phase->values[0]);
+        }
+        else
+        {
+            fprintf(file, " %8s\n", "n/a");
+        }
+    }
+}
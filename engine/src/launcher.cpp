@@ -72,6 +72,11 @@ void gv::GvsocLauncher::open()
 
     js::Config *gv_config = this->handler->gv_config;
 
+    if (gv_config->get_child_bool("host_perf/enabled"))
+    {
+        this->host_perf = new HostPerf();
+    }
+
     this->proxy = NULL;
     if (gv_config->get_child_bool("proxy/enabled"))
     {
@@ -117,10 +122,26 @@ void gv::GvsocLauncher::bind(gv::Gvsoc_user *user)
 
 void gv::GvsocLauncher::start()
 {
+    if (this->host_perf)
+    {
+        this->host_perf->phase_enter("load");
+    }
+
     this->instance->build_all();
+
+    if (this->host_perf)
+    {
+        this->host_perf->phase_enter("startup");
+    }
+
     this->handler->start();
     this->instance->reset_all(true);
     this->instance->reset_all(false);
+
+    if (this->host_perf)
+    {
+        this->host_perf->phase_exit();
+    }
 }
 
 void gv::GvsocLauncher::close()
@@ -130,8 +151,21 @@ void gv::GvsocLauncher::close()
         proxy->stop(this->retval);
     }
 
+    if (this->host_perf)
+    {
+        this->host_perf->phase_enter("close");
+    }
+
     this->instance->stop_all();
 
+    if (this->host_perf)
+    {
+        this->host_perf->phase_exit();
+        this->host_perf->report(stdout);
+        delete this->host_perf;
+        this->host_perf = NULL;
+    }
+
     vp::Top *top = (vp::Top *)this->handler;
 
     delete top;
@@ -148,7 +182,15 @@ void gv::GvsocLauncher::run()
     }
     else
     {
+        if (this->host_perf)
+        {
+            this->host_perf->phase_enter("run");
+        }
         this->handler->get_time_engine()->run();
+        if (this->host_perf)
+        {
+            this->host_perf->phase_exit();
+        }
     }
 }
 
@@ -225,7 +267,15 @@ int64_t gv::GvsocLauncher::step_until(int64_t end_time)
             x->notify_run(this->handler->get_time_engine()->get_time());
         }
 
+        if (this->host_perf)
+        {
+            this->host_perf->phase_enter("step");
+        }
         time = this->handler->get_time_engine()->run_until(end_time);
+        if (this->host_perf)
+        {
+            this->host_perf->phase_exit();
+        }
 
         for (auto x: this->exec_notifiers)
         {
@@ -320,6 +370,11 @@ void gv::GvsocLauncher::engine_routine()
 
         this->handler->get_time_engine()->critical_notify();
 
+        if (this->host_perf)
+        {
+            this->host_perf->phase_enter("run");
+        }
+
         // Run until we are ask to stop or simulation is over
         while (this->running)
         {
@@ -336,6 +391,11 @@ void gv::GvsocLauncher::engine_routine()
             }
         }
 
+        if (this->host_perf)
+        {
+            this->host_perf->phase_exit();
+        }
+
         // Properly notify the stop and finish state
         for (auto x: this->exec_notifiers)
         {
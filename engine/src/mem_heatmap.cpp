@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <vp/vp.hpp>
+#include <vp/profiler_output.hpp>
+#include <vp/mem_heatmap.hpp>
+
+
+vp::MemHeatmap::MemHeatmap(vp::Component &top, std::string name)
+    : top(top), name(name), active(false), base(0), size(0), block_shift(0), nb_blocks(0),
+    reads(NULL), writes(NULL)
+{
+    top.traces.new_trace(name == "" ? "mem_heatmap" : name + "/mem_heatmap", &this->trace,
+        vp::DEBUG);
+}
+
+
+
+vp::MemHeatmap::~MemHeatmap()
+{
+    this->dump();
+}
+
+
+
+void vp::MemHeatmap::init(uint64_t base, uint64_t size)
+{
+    js::Config *config = vp::profiler_get_config(this->top, "mem_heatmap");
+    if (config == NULL || size == 0)
+    {
+        return;
+    }
+
+    int64_t block_size = config->get_int("block_size");
+    if (block_size <= 0 || (block_size & (block_size - 1)) != 0)
+    {
+        this->trace.force_warning("Invalid heatmap block size, heatmap is disabled "
+            "(block_size: %lld)\n", block_size);
+        return;
+    }
+
+    this->path = vp::profiler_get_path(this->top, config, this->name, "heatmap");
+    this->base = base;
+    this->size = size;
+    this->block_shift = __builtin_ctzll(block_size);
+    this->nb_blocks = (size + block_size - 1) >> this->block_shift;
+    this->reads = new uint32_t[this->nb_blocks]();
+    this->writes = new uint32_t[this->nb_blocks]();
+    this->active = true;
+
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Enabled memory heatmap (base: 0x%llx, size: 0x%llx, "
+        "block_size: %lld)\n", base, size, block_size);
+}
+
+
+
+void vp::MemHeatmap::dump()
+{
+    if (!this->active)
+    {
+        return;
+    }
+
+    this->active = false;
+
+    FILE *file = vp::profiler_open_file(&this->trace, this->path, "heatmap");
+    if (file != NULL)
+    {
+        uint32_t block_size = 1 << this->block_shift;
+        uint32_t nb_blocks = this->nb_blocks;
+        fwrite(MEM_HEATMAP_MAGIC, 1, 8, file);
+        fwrite(&this->base, sizeof(this->base), 1, file);
+        fwrite(&this->size, sizeof(this->size), 1, file);
+        fwrite(&block_size, sizeof(block_size), 1, file);
+        fwrite(&nb_blocks, sizeof(nb_blocks), 1, file);
+        fwrite(this->reads, sizeof(uint32_t), this->nb_blocks, file);
+        fwrite(this->writes, sizeof(uint32_t), this->nb_blocks, file);
+        fclose(file);
+    }
+
+    delete[] this->reads;
+    delete[] this->writes;
+    this->reads = NULL;
+    this->writes = NULL;
+}
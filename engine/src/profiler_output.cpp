@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <vp/vp.hpp>
+#include <vp/profiler_output.hpp>
+
+
+js::Config *vp::profiler_get_config(vp::Component &top, std::string section)
+{
+    js::Config *config = top.gv_config->get(section);
+    if (config == NULL || !config->get_child_bool("enabled"))
+    {
+        return NULL;
+    }
+    return config;
+}
+
+
+
+std::string vp::profiler_get_path(vp::Component &top, js::Config *config, std::string name,
+    std::string extension)
+{
+    std::string dir = config->get_child_str("path");
+    if (dir == "")
+    {
+        dir = ".";
+    }
+
+    std::string file_name = top.get_path();
+    if (file_name.size() > 0 && file_name[0] == '/')
+    {
+        file_name = file_name.substr(1);
+    }
+    for (char &c: file_name)
+    {
+        if (c == '/')
+        {
+            c = '.';
+        }
+    }
+    if (name != "")
+    {
+        file_name += "." + name;
+    }
+
+    return dir + "/" + file_name + "." + extension;
+}
+
+
+
+FILE *vp::profiler_open_file(vp::Trace *trace, std::string path, std::string kind)
+{
+    std::string dir = path.substr(0, path.rfind('/'));
+    if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST)
+    {
+        trace->force_warning("Unable to create %s directory (path: %s, error: %s)\n",
+            kind.c_str(), dir.c_str(), strerror(errno));
+        return NULL;
+    }
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == NULL)
+    {
+        trace->force_warning("Unable to open %s file (path: %s, error: %s)\n",
+            kind.c_str(), path.c_str(), strerror(errno));
+        return NULL;
+    }
+
+    trace->msg(vp::Trace::LEVEL_INFO, "Opened %s file (path: %s)\n", kind.c_str(), path.c_str());
+
+    return file;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vp/vp.hpp>
+#include <vp/profiler_output.hpp>
+#include <vp/traffic_profiler.hpp>
+
+
+vp::TrafficProfiler::TrafficProfiler(vp::Component &top)
+    : top(top), active(false), bin_size(1), current_bin(-1), file(NULL)
+{
+    top.traces.new_trace("traffic_profiler", &this->trace, vp::DEBUG);
+
+    js::Config *config = vp::profiler_get_config(top, "traffic_profiler");
+    if (config == NULL)
+    {
+        return;
+    }
+
+    this->bin_size = config->get_int("bin_size");
+    if (this->bin_size <= 0)
+    {
+        this->trace.force_warning("Invalid traffic profiler bin size, profiler is disabled "
+            "(bin_size: %lld)\n", this->bin_size);
+        return;
+    }
+
+    this->path = vp::profiler_get_path(top, config, "", "traffic");
+    this->active = true;
+}
+
+
+
+vp::TrafficProfiler::~TrafficProfiler()
+{
+    this->dump();
+}
+
+
+
+int vp::TrafficProfiler::add_channel(std::string name)
+{
+    this->channel_names.push_back(name);
+    this->bins.push_back({});
+    return this->channel_names.size() - 1;
+}
+
+
+
+void vp::TrafficProfiler::switch_bin(int64_t bin)
+{
+    if (this->current_bin != -1)
+    {
+        for (size_t i=0; i<this->bins.size(); i++)
+        {
+            Bin *stats = &this->bins[i];
+            if (stats->nb_reads == 0 && stats->nb_writes == 0)
+            {
+                continue;
+            }
+
+            Record record;
+            record.bin = this->current_bin;
+            record.read_bytes = stats->read_bytes;
+            record.write_bytes = stats->write_bytes;
+            record.stalls = stats->stalls;
+            record.channel = i;
+            record.nb_reads = stats->nb_reads;
+            record.nb_writes = stats->nb_writes;
+            record.unused = 0;
+            this->records.push_back(record);
+
+            *stats = {};
+        }
+
+        if (this->records.size() >= TRAFFIC_PROFILER_BUFFER_SIZE)
+        {
+            this->write_records();
+        }
+    }
+
+    this->current_bin = bin;
+}
+
+
+
+bool vp::TrafficProfiler::open_file()
+{
+    this->file = vp::profiler_open_file(&this->trace, this->path, "traffic profiler");
+    if (this->file == NULL)
+    {
+        return false;
+    }
+
+    uint64_t bin_size = this->bin_size;
+    uint32_t nb_channels = this->channel_names.size();
+    fwrite(TRAFFIC_PROFILER_MAGIC, 1, 8, this->file);
+    fwrite(&bin_size, sizeof(bin_size), 1, this->file);
+    fwrite(&nb_channels, sizeof(nb_channels), 1, this->file);
+    for (std::string &name: this->channel_names)
+    {
+        uint32_t len = name.size();
+        fwrite(&len, sizeof(len), 1, this->file);
+        fwrite(name.c_str(), 1, len, this->file);
+    }
+
+    return true;
+}
+
+
+
+void vp::TrafficProfiler::write_records()
+{
+    if (this->file == NULL && !this->open_file())
+    {
+        // Stop profiling on errors to not retry on every bin
+        this->active = false;
+        this->records.clear();
+        return;
+    }
+
+    fwrite(this->records.data(), sizeof(Record), this->records.size(), this->file);
+    this->records.clear();
+}
+
+
+
+void vp::TrafficProfiler::dump()
+{
+    if (!this->active)
+    {
+        return;
+    }
+
+    // Flush the bin being accumulated. The file is produced even without any traffic so that
+    // the analysis tool still reports the channels.
+    this->switch_bin(-1);
+    this->write_records();
+
+    if (this->file)
+    {
+        fclose(this->file);
+        this->file = NULL;
+    }
+
+    this->active = false;
+}
@@ -80,6 +80,7 @@ public:
     IssWrapper(vp::ComponentConf &config);
 
     void start();
+    void stop();
     void reset(bool active);
 
     Iss iss;
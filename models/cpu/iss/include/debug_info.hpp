@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define DEBUG_INFO_MAGIC "GVDBGIN1"
+
+class ElfContent;
+
+/**
+ * @brief Debug information of a binary, used for symbolizing PCs in traces
+ *
+ * The debug information is read directly from the ELF binary, using the function symbols and
+ * the DWARF line tables, or from a text file with one line per PC, giving the function,
+ * inlined function, file and line. Parsing it is slow for big binaries, so it is converted once
+ * into a binary cache, which is then directly mapped in memory on the next runs, as long as the
+ * source file is not modified. It is also only loaded the first time a PC is looked up, so that
+ * simulations without traces do not pay for it.
+ * The cache contains a table of address ranges sorted by start address, where contiguous PCs
+ * with the same information are merged, followed by a pool of strings where each string
+ * appears only once. Lookups are done with a binary search on the ranges.
+ */
+class DebugInfo
+{
+public:
+    /**
+     * @brief Construct debug information
+     *
+     * @param path Path to the text file generated from the binary, or base name of the cache if
+     *     the binary is given.
+     * @param binary Path to the ELF binary, or empty to use the text file.
+     */
+    DebugInfo(std::string path, std::string binary="");
+    ~DebugInfo();
+
+    /**
+     * @brief Get the debug information of a PC
+     *
+     * The debug information is loaded during the first call.
+     *
+     * @return 0 if the PC was found, -1 otherwise.
+     */
+    int lookup(uint64_t addr, const char **func, const char **inline_func, const char **file,
+        int *line);
+
+private:
+    class Header
+    {
+    public:
+        char magic[8];
+        // Size and modification time of the text file the cache was generated from
+        uint64_t source_size;
+        int64_t source_mtime;
+        uint32_t nb_ranges;
+        uint32_t strings_size;
+    };
+
+    class Range
+    {
+    public:
+        uint64_t base;
+        uint32_t size;
+        // Offsets of the strings in the string pool
+        uint32_t func;
+        uint32_t inline_func;
+        uint32_t file;
+        int32_t line;
+        uint32_t unused;
+    };
+
+    // Load the debug information from the cache or from the source file
+    int load();
+    // Map the cache if it is valid for the specified source file
+    int map_cache(std::string cache_path, uint64_t source_size, int64_t source_mtime);
+    // Parse the text file into entries
+    int parse_text(const char *path, std::vector<Range> &entries);
+    // Parse the ELF symbols and DWARF line tables into entries
+    int parse_elf(const char *path, std::vector<Range> &entries);
+    // Parse the line tables of an ELF binary
+    void parse_debug_line(ElfContent *elf, std::vector<Range> &entries);
+    // Merge the entries into ranges and generate the cache content
+    void build(std::vector<Range> &entries, uint64_t source_size, int64_t source_mtime);
+    // Write the generated content to the cache file
+    void write_cache(std::string cache_path);
+    void set_content(uint8_t *data);
+    // Return the offset of a string in the pool, adding it only if it is not already there
+    uint32_t string_get(const char *str);
+
+    std::string path;
+    std::string binary;
+    bool loaded;
+    bool load_failed;
+
+    // Cache file mapping, or NULL if the content is only in the buffer
+    void *mapped;
+    size_t mapped_size;
+    // Content generated when the cache could not be used
+    std::vector<uint8_t> buffer;
+
+    Range *ranges;
+    uint32_t nb_ranges;
+    const char *strings;
+
+    // String pool being built, only used while generating the content
+    std::string build_strings;
+    std::unordered_map<std::string, uint32_t> build_string_offsets;
+};
@@ -147,7 +147,17 @@ inline iss_reg_t Exec::insn_exec_fast(iss_insn_t *insn, iss_reg_t pc)
 
 inline bool Exec::can_switch_to_fast_mode()
 {
-    if (this->iss.gdbserver.is_enabled())
+    // Single-stepping is only handled by the full instruction handlers. Breakpoints are patched
+    // in both handlers and watchpoints are checked by the LSU in both, so they do not prevent
+    // the fast mode.
+    if (this->iss.gdbserver.is_enabled() && this->step_mode.get())
+    {
+        return false;
+    }
+
+    // Accesses done directly to the memory array are only accounted in the heatmap by the full
+    // instruction handlers, so that the fast ones do not pay for it
+    if (this->iss.lsu.heatmap->get_active())
     {
         return false;
     }
@@ -25,6 +25,15 @@
 #include <mutex>
 #include <condition_variable>
 
+// Watchpoints are tagged on pages of this size so that accesses to other pages can skip
+// the watchpoint lists
+#define GDBSERVER_WATCHPOINT_PAGE_BITS 12
+// Number of entries of the direct-mapped tables of tagged pages
+#define GDBSERVER_WATCHPOINT_TABLE_BITS 10
+#define GDBSERVER_WATCHPOINT_TABLE_SIZE (1 << GDBSERVER_WATCHPOINT_TABLE_BITS)
+// Memory accesses from gdb are split into requests of at most this size, aligned on it
+#define GDBSERVER_IO_BLOCK_SIZE 4096
+
 class Watchpoint
 {
 public:
@@ -33,6 +42,44 @@ public:
     int size;
 };
 
+/**
+ * @brief Set of breakpoint addresses
+ *
+ * This is an open-addressing hash table with linear probing, so that checking if an address
+ * has a breakpoint is done in constant time whatever the number of breakpoints, which is
+ * what is done for every decoded instruction.
+ */
+class BreakpointSet
+{
+public:
+    BreakpointSet();
+    // Add an address, return false if it was already in the set
+    bool insert(iss_addr_t addr);
+    // Remove an address, return false if it was not in the set
+    bool remove(iss_addr_t addr);
+    inline bool contains(iss_addr_t addr);
+    inline bool empty() { return this->nb_entries == 0; }
+    // Return all addresses currently in the set
+    std::vector<iss_addr_t> get_all();
+
+private:
+    enum slot_state_e : uint8_t {
+        SLOT_EMPTY,
+        SLOT_USED,
+        SLOT_DELETED,
+    };
+
+    inline uint64_t slot_index(iss_addr_t addr);
+    void rehash(int bits);
+
+    std::vector<iss_addr_t> keys;
+    std::vector<uint8_t> states;
+    // log2 of the number of slots
+    int bits;
+    int nb_entries;
+    int nb_deleted;
+};
+
 class Gdbserver : public vp::Gdbserver_core
 {
 public:
@@ -62,7 +109,8 @@ public:
     void enable_breakpoint(iss_addr_t addr);
     void disable_breakpoint(iss_addr_t addr);
     void enable_all_breakpoints();
-    bool watchpoint_check(bool is_write, iss_addr_t addr, int size);
+    inline bool watchpoint_check(bool is_write, iss_addr_t addr, int size);
+    bool watchpoint_check_slow(bool is_write, iss_addr_t addr, int size);
 
     void handle_pending_io_access();
     static void handle_pending_io_access_stub(vp::Block *__this, vp::ClockEvent *event);
@@ -74,13 +122,18 @@ public:
 
     void decode_insn(iss_insn_t *insn, iss_addr_t pc);
 
+private:
+    void watchpoint_pages_update(bool is_write, iss_addr_t addr, int size, int incr);
+
+public:
+
     Iss &iss;
     vp::IoMaster io_itf;
     vp::IoReq io_req;
     vp::Trace trace;
     vp::ClockEvent *event;
     vp::Gdbserver_engine *gdbserver;
-    std::list<iss_addr_t> breakpoints;
+    BreakpointSet breakpoints;
     bool halt_on_reset;
     std::mutex mutex;
     std::condition_variable cond;
@@ -90,7 +143,64 @@ public:
     int io_pending_size;
     uint8_t *io_pending_data;
     bool io_pending_is_write;
+    // True when the target rejected block accesses and register-width accesses must be used
+    bool io_pending_word_access;
     std::list<Watchpoint *> write_watchpoints;
     std::list<Watchpoint *> read_watchpoints;
+    int nb_watchpoints;
+    // Number of watchpoints covering each page, indexed by page number modulo the table size.
+    // An access can only hit a watchpoint if one of its pages has a non-zero entry.
+    uint16_t write_watchpoint_pages[GDBSERVER_WATCHPOINT_TABLE_SIZE];
+    uint16_t read_watchpoint_pages[GDBSERVER_WATCHPOINT_TABLE_SIZE];
     int id;
-};
\ No newline at end of file
+};
+
+
+
+inline uint64_t BreakpointSet::slot_index(iss_addr_t addr)
+{
+    // Fibonacci hashing, instruction addresses are at least 2-bytes aligned
+    return ((uint64_t)(addr >> 1) * 0x9E3779B97F4A7C15ULL) >> (64 - this->bits);
+}
+
+inline bool BreakpointSet::contains(iss_addr_t addr)
+{
+    if (likely(this->nb_entries == 0))
+    {
+        return false;
+    }
+
+    uint64_t mask = (1ULL << this->bits) - 1;
+    for (uint64_t index = this->slot_index(addr);; index = (index + 1) & mask)
+    {
+        uint8_t state = this->states[index];
+        if (state == SLOT_EMPTY)
+        {
+            return false;
+        }
+        if (state == SLOT_USED && this->keys[index] == addr)
+        {
+            return true;
+        }
+    }
+}
+
+
+
+inline bool Gdbserver::watchpoint_check(bool is_write, iss_addr_t addr, int size)
+{
+    if (likely(this->nb_watchpoints == 0))
+    {
+        return false;
+    }
+
+    uint16_t *pages = is_write ? this->write_watchpoint_pages : this->read_watchpoint_pages;
+    iss_addr_t mask = GDBSERVER_WATCHPOINT_TABLE_SIZE - 1;
+    if (likely(pages[(addr >> GDBSERVER_WATCHPOINT_PAGE_BITS) & mask] == 0 &&
+        pages[((addr + size - 1) >> GDBSERVER_WATCHPOINT_PAGE_BITS) & mask] == 0))
+    {
+        return false;
+    }
+
+    return this->watchpoint_check_slow(is_write, addr, size);
+}
@@ -39,8 +39,10 @@ public:
     void build();
     void flush();
     bool insn_is_decoded(iss_insn_t *insn);
-    iss_insn_t *get_insn_from_cache(iss_reg_t vaddr, iss_reg_t &index);
-    inline iss_insn_t *get_insn(iss_reg_t vaddr, iss_reg_t &index);
+    // is_fetch must be false when the instruction is not about to be executed, so that no
+    // access fault is raised for it
+    iss_insn_t *get_insn_from_cache(iss_reg_t vaddr, iss_reg_t &index, bool is_fetch=true);
+    inline iss_insn_t *get_insn(iss_reg_t vaddr, iss_reg_t &index, bool is_fetch=true);
     void mode_flush();
     inline void insn_init(iss_insn_t *insn, iss_addr_t addr);
     InsnPage *page_get(iss_reg_t paddr);
@@ -56,7 +58,7 @@ private:
 
 
 
-inline iss_insn_t *InsnCache::get_insn(iss_reg_t vaddr, iss_reg_t &index)
+inline iss_insn_t *InsnCache::get_insn(iss_reg_t vaddr, iss_reg_t &index, bool is_fetch)
 {
     index = (vaddr - this->current_insn_page_base) >> 1;
     if (likely(index < INSN_PAGE_SIZE))
@@ -64,7 +66,7 @@ inline iss_insn_t *InsnCache::get_insn(iss_reg_t vaddr, iss_reg_t &index)
         return &this->current_insn_page->insns[index];
     }
 
-    return this->get_insn_from_cache(vaddr, index);
+    return this->get_insn_from_cache(vaddr, index, is_fetch);
 }
 
 inline void InsnCache::insn_init(iss_insn_t *insn, iss_addr_t addr)
@@ -72,6 +74,7 @@ inline void InsnCache::insn_init(iss_insn_t *insn, iss_addr_t addr)
     insn->handler = iss_decode_pc_handler;
     insn->fast_handler = iss_decode_pc_handler;
     insn->addr = addr;
+    insn->nb_breakpoints = 0;
 #if defined(CONFIG_GVSOC_ISS_RI5KY)
     insn->hwloop_handler = NULL;
 #endif
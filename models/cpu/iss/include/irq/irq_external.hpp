@@ -39,6 +39,9 @@ public:
     bool stvec_set(iss_addr_t base);
     inline void global_enable(int enable);
     void cache_flush();
+    // Interrupts are only received through the request interface on this core, nothing to
+    // update when the CSRs or the mode are modified
+    void pending_update() {}
     void reset(bool active);
     int check();
     void wfi_handle();
@@ -64,6 +64,7 @@ public:
     void wfi_handle();
     void elw_irq_unstall();
     void check_interrupts();
+    void pending_update();
     static void msi_sync(vp::Block *__this, bool value);
     static void mti_sync(vp::Block *__this, bool value);
     static void mei_sync(vp::Block *__this, bool value);
@@ -77,6 +78,12 @@ public:
     int req_irq;
     bool req_debug;
     iss_reg_t debug_handler;
+    // Interrupts which are both pending and enabled in the current mode, and the mode which
+    // will handle them. This is updated each time mip, mie, mideleg, mstatus or the mode is
+    // modified, so that instructions only switch to the slow path checking interrupts when
+    // one can be taken.
+    iss_reg_t enabled_interrupts;
+    int enabled_interrupts_mode;
     vp::Trace trace;
     vp::WireSlave<bool> msi_itf;
     vp::WireSlave<bool> mti_itf;
@@ -30,5 +30,6 @@ inline void Irq::global_enable(int enable)
                     enable);
 
     this->iss.irq.irq_enable.set(enable);
-    this->iss.exec.switch_to_full_mode();
+    // The instruction loop switches to the slow path only if an interrupt can now be taken
+    this->pending_update();
 }
@@ -36,7 +36,10 @@
 
 static inline iss_reg_t LB_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int8_t>(insn, REG_GET(0) + REG_GET(1), 1, REG_OUT(0));
+    if (iss->lsu.load_signed<int8_t>(insn, REG_GET(0) + REG_GET(1), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -53,7 +56,10 @@ static inline iss_reg_t LB_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t LH_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int16_t>(insn, REG_GET(0) + REG_GET(1), 2, REG_OUT(0));
+    if (iss->lsu.load_signed<int16_t>(insn, REG_GET(0) + REG_GET(1), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -70,7 +76,10 @@ static inline iss_reg_t LH_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t LW_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<int32_t>(insn, REG_GET(0) + REG_GET(1), 4, REG_OUT(0));
+    if (iss->lsu.load<int32_t>(insn, REG_GET(0) + REG_GET(1), 4, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -87,7 +96,10 @@ static inline iss_reg_t LW_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t LBU_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<int8_t>(insn, REG_GET(0) + REG_GET(1), 1, REG_OUT(0));
+    if (iss->lsu.load<int8_t>(insn, REG_GET(0) + REG_GET(1), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -104,7 +116,10 @@ static inline iss_reg_t LBU_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t LHU_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<int16_t>(insn, REG_GET(0) + REG_GET(1), 2, REG_OUT(0));
+    if (iss->lsu.load<int16_t>(insn, REG_GET(0) + REG_GET(1), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -121,7 +136,10 @@ static inline iss_reg_t LHU_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t LB_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int8_t>(insn, REG_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load_signed<int8_t>(insn, REG_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -138,7 +156,10 @@ static inline iss_reg_t LB_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 
 static inline iss_reg_t LH_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int16_t>(insn, REG_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load_signed<int16_t>(insn, REG_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -155,7 +176,10 @@ static inline iss_reg_t LH_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 
 static inline iss_reg_t LW_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int32_t>(insn, REG_GET(0), 4, REG_OUT(0));
+    if (iss->lsu.load_signed<int32_t>(insn, REG_GET(0), 4, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -172,7 +196,10 @@ static inline iss_reg_t LW_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 
 static inline iss_reg_t LBU_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<int8_t>(insn, REG_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load<int8_t>(insn, REG_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -190,7 +217,10 @@ static inline iss_reg_t LBU_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t p
 
 static inline iss_reg_t LHU_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<int16_t>(insn, REG_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load<int16_t>(insn, REG_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -208,7 +238,10 @@ static inline iss_reg_t LHU_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t p
 
 static inline iss_reg_t SB_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint8_t>(insn, REG_GET(0), 1, REG_IN(1));
+    if (iss->lsu.store<uint8_t>(insn, REG_GET(0), 1, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -226,7 +259,10 @@ static inline iss_reg_t SB_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 
 static inline iss_reg_t SH_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint16_t>(insn, REG_GET(0), 2, REG_IN(1));
+    if (iss->lsu.store<uint16_t>(insn, REG_GET(0), 2, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -244,7 +280,10 @@ static inline iss_reg_t SH_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 
 static inline iss_reg_t SW_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint32_t>(insn, REG_GET(0), 4, REG_IN(1));
+    if (iss->lsu.store<uint32_t>(insn, REG_GET(0), 4, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, REG_GET(0) + SIM_GET(0));
     return iss_insn_next(iss, insn, pc);
 }
@@ -263,7 +302,10 @@ static inline iss_reg_t SW_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc
 static inline iss_reg_t LB_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(1);
-    iss->lsu.load_signed<int8_t>(insn, REG_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load_signed<int8_t>(insn, REG_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -282,7 +324,10 @@ static inline iss_reg_t LB_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t
 static inline iss_reg_t LH_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(1);
-    iss->lsu.load_signed<int16_t>(insn, REG_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load_signed<int16_t>(insn, REG_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -301,7 +346,10 @@ static inline iss_reg_t LH_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t
 static inline iss_reg_t LW_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(1);
-    iss->lsu.load_signed<int32_t>(insn, REG_GET(0), 4, REG_OUT(0));
+    if (iss->lsu.load_signed<int32_t>(insn, REG_GET(0), 4, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -320,7 +368,10 @@ static inline iss_reg_t LW_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t
 static inline iss_reg_t LBU_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(1);
-    iss->lsu.load<uint8_t>(insn, REG_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load<uint8_t>(insn, REG_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -340,7 +391,10 @@ static inline iss_reg_t LBU_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_
 static inline iss_reg_t LHU_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(1);
-    iss->lsu.load<uint16_t>(insn, REG_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load<uint16_t>(insn, REG_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -360,7 +414,10 @@ static inline iss_reg_t LHU_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_
 static inline iss_reg_t SB_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(2);
-    iss->lsu.store<uint8_t>(insn, REG_GET(0), 1, REG_IN(1));
+    if (iss->lsu.store<uint8_t>(insn, REG_GET(0), 1, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -380,7 +437,10 @@ static inline iss_reg_t SB_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t
 static inline iss_reg_t SH_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(2);
-    iss->lsu.store<uint16_t>(insn, REG_GET(0), 2, REG_IN(1));
+    if (iss->lsu.store<uint16_t>(insn, REG_GET(0), 2, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -400,7 +460,10 @@ static inline iss_reg_t SH_RR_POSTINC_exec(Iss *iss, iss_insn_t *insn, iss_reg_t
 static inline iss_reg_t SW_RR_POSTINC_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss_reg_t new_val = REG_GET(0) + REG_GET(2);
-    iss->lsu.store<uint32_t>(insn, REG_GET(0), 4, REG_IN(1));
+    if (iss->lsu.store<uint32_t>(insn, REG_GET(0), 4, REG_IN(1)))
+    {
+        return pc;
+    }
     IN_REG_SET(0, new_val);
     return iss_insn_next(iss, insn, pc);
 }
@@ -665,7 +728,10 @@ static inline iss_reg_t p_abs_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t SB_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint8_t>(insn, REG_GET(0) + REG_GET(2), 1, REG_IN(1));
+    if (iss->lsu.store<uint8_t>(insn, REG_GET(0) + REG_GET(2), 1, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -682,7 +748,10 @@ static inline iss_reg_t SB_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t SH_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint16_t>(insn, REG_GET(0) + REG_GET(2), 2, REG_IN(1));
+    if (iss->lsu.store<uint16_t>(insn, REG_GET(0) + REG_GET(2), 2, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -699,7 +768,10 @@ static inline iss_reg_t SH_RR_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t SW_RR_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint32_t>(insn, REG_GET(0) + REG_GET(2), 4, REG_IN(1));
+    if (iss->lsu.store<uint32_t>(insn, REG_GET(0) + REG_GET(2), 4, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -260,7 +260,10 @@ static inline iss_reg_t bgeu_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t lb_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load_signed<int8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -276,7 +279,10 @@ static inline iss_reg_t lb_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t lh_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load_signed<int16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -292,7 +298,10 @@ static inline iss_reg_t lh_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t lw_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_signed<int32_t>(insn, REG_GET(0) + SIM_GET(0), 4, REG_OUT(0));
+    if (iss->lsu.load_signed<int32_t>(insn, REG_GET(0) + SIM_GET(0), 4, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -308,7 +317,10 @@ static inline iss_reg_t lw_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t lbu_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<uint8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_OUT(0));
+    if (iss->lsu.load<uint8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -324,7 +336,10 @@ static inline iss_reg_t lbu_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t lhu_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -340,7 +355,10 @@ static inline iss_reg_t lhu_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t sb_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_IN(1));
+    if (iss->lsu.store<uint8_t>(insn, REG_GET(0) + SIM_GET(0), 1, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -356,7 +374,10 @@ static inline iss_reg_t sb_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t sh_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_IN(1));
+    if (iss->lsu.store<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -372,7 +393,10 @@ static inline iss_reg_t sh_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 
 static inline iss_reg_t sw_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store<uint32_t>(insn, REG_GET(0) + SIM_GET(0), 4, REG_IN(1));
+    if (iss->lsu.store<uint32_t>(insn, REG_GET(0) + SIM_GET(0), 4, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -529,7 +553,7 @@ static inline iss_reg_t ebreak_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
     // The good solution would be to issue load requests and be able to stall the instruction
     // until we got the previous opcode
     iss_reg_t index;
-    iss_insn_t *prev = iss->insn_cache.get_insn(pc - 4, index);
+    iss_insn_t *prev = iss->insn_cache.get_insn(pc - 4, index, false);
     if (prev == NULL)
     {
         return pc;
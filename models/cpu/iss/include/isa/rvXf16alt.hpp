@@ -30,14 +30,20 @@
 static inline iss_reg_t flah_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss->lsu.stack_access_check(REG_IN(0), REG_GET(0) + SIM_GET(0));
-    iss->lsu.load<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0));
+    if (iss->lsu.load<uint16_t, true>(insn, REG_GET(0) + SIM_GET(0), 2, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
 static inline iss_reg_t fsah_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss->lsu.stack_access_check(REG_OUT(0), REG_GET(0) + SIM_GET(0));
-    iss->lsu.store<uint16_t>(insn, REG_GET(0) + SIM_GET(0), 2, REG_IN(1));
+    if (iss->lsu.store<uint16_t, true>(insn, REG_GET(0) + SIM_GET(0), 2, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -27,27 +27,39 @@
 
 static inline iss_reg_t fld_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.load_float<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_OUT(0));
+    if (iss->lsu.load_float<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
 static inline iss_reg_t fld_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss->lsu.stack_access_check(REG_IN(0), REG_GET(0) + SIM_GET(0));
-    iss->lsu.load_float_perf<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_OUT(0));
+    if (iss->lsu.load_float_perf<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_OUT(0)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
 static inline iss_reg_t fsd_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
-    iss->lsu.store_float<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_IN(1));
+    if (iss->lsu.store_float<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
 static inline iss_reg_t fsd_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
 {
     iss->lsu.stack_access_check(REG_OUT(0), REG_GET(0) + SIM_GET(0));
-    iss->lsu.store_float_perf<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_IN(1));
+    if (iss->lsu.store_float_perf<uint64_t>(insn, REG_GET(0) + SIM_GET(0), 8, REG_IN(1)))
+    {
+        return pc;
+    }
     return iss_insn_next(iss, insn, pc);
 }
 
@@ -28,7 +28,6 @@
 void update_external_pccr(Iss *iss, int id, unsigned int pcer, unsigned int pcmr);
 
 void iss_trace_dump(Iss *iss, iss_insn_t *insn, iss_reg_t pc);
-void iss_trace_init(Iss *iss);
 
 iss_reg_t iss_exec_insn_with_trace(Iss *iss, iss_insn_t *insn, iss_reg_t pc);
 
@@ -36,7 +35,7 @@ void iss_reset(Iss *iss, int active);
 
 iss_decoder_item_t *iss_isa_get(Iss *iss);
 
-void iss_register_debug_info(Iss *iss, const char *binary);
+void iss_register_debug_info(Iss *iss, const char *path, const char *binary="");
 
 iss_reg_t iss_decode_pc_handler(Iss *cpu, iss_insn_t *insn, iss_reg_t pc);
 
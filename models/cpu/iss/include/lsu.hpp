@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cpu/iss/include/types.hpp>
+#include <vp/mem_heatmap.hpp>
 
 #define ADDR_MASK (~(ISS_REG_WIDTH / 8 - 1))
 
@@ -32,6 +33,7 @@ public:
 
     void build();
     void start();
+    void stop();
     void reset(bool active);
 
     int data_req(iss_addr_t addr, uint8_t *data, int size, bool is_write, int64_t &latency);
@@ -42,28 +44,28 @@ public:
     static void data_grant(vp::Block *__this, vp::IoReq *req);
     static void data_response(vp::Block *__this, vp::IoReq *req);
 
-    template<typename T>
+    template<typename T, bool heatmap=false>
     inline bool store(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
     template<typename T>
     inline bool store_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
-    template<typename T>
+    template<typename T, bool heatmap=false>
     inline bool load(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
     template<typename T>
     inline bool load_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
-    template<typename T>
+    template<typename T, bool heatmap=false>
     inline bool load_signed(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
     template<typename T>
     inline bool load_signed_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
-    template<typename T>
+    template<typename T, bool heatmap=false>
     inline bool load_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
-    template<typename T>
+    template<typename T, bool heatmap=false>
     inline bool store_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg);
 
     template<typename T>
@@ -79,6 +81,10 @@ public:
 
     inline void stack_access_check(int reg, iss_addr_t addr);
 
+    // Account an access done directly to the memory array into the heatmap. Only the LSU
+    // variants instantiated with heatmap set call it, the other ones skip it at compile time.
+    inline void mem_array_account(iss_addr_t phys_addr, int size, bool is_write);
+
     Iss &iss;
 
     vp::Trace trace;
@@ -102,6 +108,9 @@ public:
     uint8_t *mem_array;
     iss_addr_t memory_start;
     iss_addr_t memory_end;
+    // Heatmap of the accesses done directly to the memory array, as they are not seen by the
+    // memory model
+    vp::MemHeatmap *heatmap;
 
 private:
     static void store_resume(void *_this);
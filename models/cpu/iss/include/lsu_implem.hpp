@@ -23,9 +23,22 @@
 
 #include "cpu/iss/include/iss_core.hpp"
 
-template<typename T>
+inline void Lsu::mem_array_account(iss_addr_t phys_addr, int size, bool is_write)
+{
+    if (this->heatmap->get_active())
+    {
+        this->heatmap->account(phys_addr - this->memory_start, size, is_write);
+    }
+}
+
+template<typename T, bool heatmap>
 inline bool Lsu::load(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
+    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    {
+        return true;
+    }
+
     iss_addr_t phys_addr;
     bool use_mem_array;
     if (this->iss.mmu.load_virt_to_phys(addr, phys_addr, use_mem_array))
@@ -33,10 +46,21 @@ inline bool Lsu::load(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
         return false;
     }
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    if (this->iss.pmp.load_check(phys_addr, size))
+    {
+        return false;
+    }
+#endif
+
 #ifdef CONFIG_GVSOC_ISS_MEMORY
 
     if (use_mem_array)
     {
+        if (heatmap)
+        {
+            this->mem_array_account(phys_addr, sizeof(T), false);
+        }
         this->iss.regfile.set_reg(reg, *(T *)&this->mem_array[phys_addr - this->memory_start]);
 
         return false;
@@ -112,9 +136,14 @@ inline void Lsu::elw(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
     }
 }
 
-template<typename T>
+template<typename T, bool heatmap>
 inline bool Lsu::load_signed(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
+    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    {
+        return true;
+    }
+
     iss_addr_t phys_addr;
     bool use_mem_array;
     if (this->iss.mmu.load_virt_to_phys(addr, phys_addr, use_mem_array))
@@ -122,10 +151,21 @@ inline bool Lsu::load_signed(iss_insn_t *insn, iss_addr_t addr, int size, int re
         return false;
     }
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    if (this->iss.pmp.load_check(phys_addr, size))
+    {
+        return false;
+    }
+#endif
+
 #ifdef CONFIG_GVSOC_ISS_MEMORY
 
     if (use_mem_array)
     {
+        if (heatmap)
+        {
+            this->mem_array_account(phys_addr, sizeof(T), false);
+        }
         this->iss.regfile.set_reg(reg, *(T *)&this->mem_array[phys_addr - this->memory_start]);
 
         return false;
@@ -171,9 +211,14 @@ inline bool Lsu::load_signed(iss_insn_t *insn, iss_addr_t addr, int size, int re
     return false;
 }
 
-template<typename T>
+template<typename T, bool heatmap>
 inline bool Lsu::store(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
+    if (this->iss.gdbserver.watchpoint_check(true, addr, size))
+    {
+        return true;
+    }
+
     iss_addr_t phys_addr;
     bool use_mem_array;
     if (this->iss.mmu.store_virt_to_phys(addr, phys_addr, use_mem_array))
@@ -181,10 +226,21 @@ inline bool Lsu::store(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
         return false;
     }
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    if (this->iss.pmp.store_check(phys_addr, size))
+    {
+        return false;
+    }
+#endif
+
 #ifdef CONFIG_GVSOC_ISS_MEMORY
 
     if (use_mem_array)
     {
+        if (heatmap)
+        {
+            this->mem_array_account(phys_addr, sizeof(T), true);
+        }
         *(T *)&this->mem_array[phys_addr - this->memory_start] = this->iss.regfile.get_reg(reg);
 
         return false;
@@ -236,12 +292,13 @@ inline bool Lsu::store(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 template<typename T>
 inline bool Lsu::load_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
-    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    // Accesses replayed after a watchpoint hit are only accounted once
+    if (this->load<T, true>(insn, addr, size, reg))
     {
         return true;
     }
     this->iss.timing.event_load_account(1);
-    return this->load<T>(insn, addr, size, reg);
+    return false;
 }
 
 inline void Lsu::elw_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
@@ -253,23 +310,25 @@ inline void Lsu::elw_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 template<typename T>
 inline bool Lsu::load_signed_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
-    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    // Accesses replayed after a watchpoint hit are only accounted once
+    if (this->load_signed<T, true>(insn, addr, size, reg))
     {
         return true;
     }
     this->iss.timing.event_load_account(1);
-    return this->load_signed<T>(insn, addr, size, reg);
+    return false;
 }
 
 template<typename T>
 inline bool Lsu::store_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
-    if (this->iss.gdbserver.watchpoint_check(true, addr, size))
+    // Accesses replayed after a watchpoint hit are only accounted once
+    if (this->store<T, true>(insn, addr, size, reg))
     {
         return true;
     }
     this->iss.timing.event_store_account(1);
-    return this->store<T>(insn, addr, size, reg);
+    return false;
 }
 
 inline void Lsu::stack_access_check(int reg, iss_addr_t addr)
@@ -287,9 +346,14 @@ inline void Lsu::stack_access_check(int reg, iss_addr_t addr)
     }
 }
 
-template<typename T>
+template<typename T, bool heatmap>
 inline bool Lsu::load_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
+    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    {
+        return true;
+    }
+
     iss_addr_t phys_addr;
     bool use_mem_array;
     if (this->iss.mmu.load_virt_to_phys(addr, phys_addr, use_mem_array))
@@ -297,10 +361,21 @@ inline bool Lsu::load_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg
         return false;
     }
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    if (this->iss.pmp.load_check(phys_addr, size))
+    {
+        return false;
+    }
+#endif
+
 #ifdef CONFIG_GVSOC_ISS_MEMORY
 
     if (use_mem_array)
     {
+        if (heatmap)
+        {
+            this->mem_array_account(phys_addr, sizeof(T), false);
+        }
         this->iss.regfile.set_freg(reg, iss_get_float_value(*(T *)&this->mem_array[phys_addr - this->memory_start], size * 8));
 
         return false;
@@ -346,9 +421,14 @@ inline bool Lsu::load_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg
     return false;
 }
 
-template<typename T>
+template<typename T, bool heatmap>
 inline bool Lsu::store_float(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
+    if (this->iss.gdbserver.watchpoint_check(true, addr, size))
+    {
+        return true;
+    }
+
     iss_addr_t phys_addr;
     bool use_mem_array;
     if (this->iss.mmu.store_virt_to_phys(addr, phys_addr, use_mem_array))
@@ -356,10 +436,21 @@ inline bool Lsu::store_float(iss_insn_t *insn, iss_addr_t addr, int size, int re
         return false;
     }
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    if (this->iss.pmp.store_check(phys_addr, size))
+    {
+        return false;
+    }
+#endif
+
 #ifdef CONFIG_GVSOC_ISS_MEMORY
 
     if (use_mem_array)
     {
+        if (heatmap)
+        {
+            this->mem_array_account(phys_addr, sizeof(T), true);
+        }
         *(T *)&this->mem_array[phys_addr - this->memory_start] = this->iss.regfile.get_freg(reg);
 
         return false;
@@ -411,21 +502,23 @@ inline bool Lsu::store_float(iss_insn_t *insn, iss_addr_t addr, int size, int re
 template<typename T>
 inline bool Lsu::load_float_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
-    if (this->iss.gdbserver.watchpoint_check(false, addr, size))
+    // Accesses replayed after a watchpoint hit are only accounted once
+    if (this->load_float<T, true>(insn, addr, size, reg))
     {
         return true;
     }
     this->iss.timing.event_load_account(1);
-    return this->load_float<T>(insn, addr, size, reg);
+    return false;
 }
 
 template<typename T>
 inline bool Lsu::store_float_perf(iss_insn_t *insn, iss_addr_t addr, int size, int reg)
 {
-    if (this->iss.gdbserver.watchpoint_check(true, addr, size))
+    // Accesses replayed after a watchpoint hit are only accounted once
+    if (this->store_float<T, true>(insn, addr, size, reg))
     {
         return true;
     }
     this->iss.timing.event_store_account(1);
-    return this->store_float<T>(insn, addr, size, reg);
+    return false;
 }
@@ -28,6 +28,17 @@
 #define CONFIG_GVSOC_ISS_PMP_NB_ENTRIES 16
 #endif
 
+// The result of the PMP checks is cached per page, so that accesses to pages which are fully
+// allowed are checked with a single tag comparison
+#define PMP_CACHE_NB_ENTRIES 256
+#define PMP_CACHE_ENTRIES_MASK 0xff
+#define PMP_PGSHIFT 12
+
+// Access types, with the same bits as the permissions in the entry configuration
+#define PMP_ACCESS_R 1
+#define PMP_ACCESS_W 2
+#define PMP_ACCESS_X 4
+
 class PmpEntry
 {
 public:
@@ -56,16 +67,45 @@ public:
     void build();
     void reset(bool active);
 
-    bool pmpcfg_read(iss_reg_t *value, int id);
-    bool pmpcfg_write(iss_reg_t value, int id);
+    bool pmpcfg_update(int id, bool is_write, iss_reg_t &value);
+    bool pmpaddr_update(int id, bool is_write, iss_reg_t &value);
+
+    // Check a physical access, return true if an access fault exception was raised
+    inline bool insn_check(iss_addr_t addr, int size);
+    inline bool load_check(iss_addr_t addr, int size);
+    inline bool store_check(iss_addr_t addr, int size);
 
-    bool pmpaddr_read(iss_reg_t *value, int id);
-    bool pmpaddr_write(iss_reg_t value, int id);
+    // Return true if the page containing the address can be entirely fetched without raising
+    // any exception.
+    inline bool insn_page_allowed(iss_addr_t addr);
+
+    // Flush the cached checks. Must be called each time the privilege mode used for the checks
+    // may have changed.
+    void flush();
 
 private:
+    // Privilege mode used for checking an access type
+    int access_mode_get(int access);
+    // Check if the page containing the address is fully allowed and cache it if so
+    bool page_check(iss_addr_t addr, int access, iss_addr_t *cache_tag);
+    bool check_miss(iss_addr_t addr, int size, int access, iss_addr_t *cache_tag);
+    bool page_allowed(iss_addr_t page, int access, int mode);
+    bool access_allowed(iss_addr_t addr, int size, int access, int mode);
     void entry_cfg_set(int id, uint8_t config);
+    void entry_addr_set(int id, iss_reg_t addr);
+    void region_update(int id);
+
+    PmpEntry entry[CONFIG_GVSOC_ISS_PMP_NB_ENTRIES];
+    iss_reg_t entry_addr[CONFIG_GVSOC_ISS_PMP_NB_ENTRIES];
+    // First and last address of the region of each entry, computed when the entry is modified.
+    // The region is empty when first is above last.
+    uint64_t region_first[CONFIG_GVSOC_ISS_PMP_NB_ENTRIES];
+    uint64_t region_last[CONFIG_GVSOC_ISS_PMP_NB_ENTRIES];
 
-    PmpEntry entry[16];
+    // Tags of the pages which are fully allowed for each access type
+    iss_addr_t cache_insn_tag[PMP_CACHE_NB_ENTRIES];
+    iss_addr_t cache_load_tag[PMP_CACHE_NB_ENTRIES];
+    iss_addr_t cache_store_tag[PMP_CACHE_NB_ENTRIES];
 
     Iss &iss;
     vp::Trace trace;
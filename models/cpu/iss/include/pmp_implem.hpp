@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vp/vp.hpp>
+#include <cpu/iss/include/types.hpp>
+#include "cpu/iss/include/pmp.hpp"
+
+inline bool Pmp::insn_check(iss_addr_t addr, int size)
+{
+    iss_addr_t tag = addr >> PMP_PGSHIFT;
+    int index = tag & PMP_CACHE_ENTRIES_MASK;
+
+    if (likely(this->cache_insn_tag[index] == tag && (addr + size - 1) >> PMP_PGSHIFT == tag))
+    {
+        return false;
+    }
+
+    return this->check_miss(addr, size, PMP_ACCESS_X, this->cache_insn_tag);
+}
+
+inline bool Pmp::load_check(iss_addr_t addr, int size)
+{
+    iss_addr_t tag = addr >> PMP_PGSHIFT;
+    int index = tag & PMP_CACHE_ENTRIES_MASK;
+
+    if (likely(this->cache_load_tag[index] == tag && (addr + size - 1) >> PMP_PGSHIFT == tag))
+    {
+        return false;
+    }
+
+    return this->check_miss(addr, size, PMP_ACCESS_R, this->cache_load_tag);
+}
+
+inline bool Pmp::store_check(iss_addr_t addr, int size)
+{
+    iss_addr_t tag = addr >> PMP_PGSHIFT;
+    int index = tag & PMP_CACHE_ENTRIES_MASK;
+
+    if (likely(this->cache_store_tag[index] == tag && (addr + size - 1) >> PMP_PGSHIFT == tag))
+    {
+        return false;
+    }
+
+    return this->check_miss(addr, size, PMP_ACCESS_W, this->cache_store_tag);
+}
+
+inline bool Pmp::insn_page_allowed(iss_addr_t addr)
+{
+    iss_addr_t tag = addr >> PMP_PGSHIFT;
+    int index = tag & PMP_CACHE_ENTRIES_MASK;
+
+    if (likely(this->cache_insn_tag[index] == tag))
+    {
+        return true;
+    }
+
+    return this->page_check(addr, PMP_ACCESS_X, this->cache_insn_tag);
+}
@@ -63,6 +63,10 @@ public:
     inline void event_account(unsigned int event, int incr);
     inline void handle_pending_events();
 
+    // Add the pending events to the performance counters which are enabled. Must be called
+    // before the counters are accessed or their configuration is modified.
+    void pccr_sync();
+
     void reset(bool active);
 
     vp::ClockEvent *ipc_clock_event;
@@ -85,6 +89,10 @@ public:
     uint32_t pcer_trace_active_events;
 
 private:
+    // Events which occurred since the performance counters were last synchronized. Events are
+    // always counted here, which is cheaper than checking on each event if its counter is
+    // enabled, and are added to the enabled counters only when pccr_sync is called.
+    int64_t pccr_pending[32];
 
     Iss &iss;
     bool declare_binaries = true;
@@ -105,12 +105,7 @@ inline int Timing::event_trace_is_active(unsigned int event)
 
 inline void Timing::event_account(unsigned int event, int incr)
 {
-    Iss *iss = &this->iss;
-
-    if (iss->csr.pcmr & CSR_PCMR_ACTIVE && (iss->csr.pcer & (1 << event)))
-    {
-        iss->csr.pccr[event] += incr;
-    }
+    this->pccr_pending[event] += incr;
 
     this->event_trace_account(event, incr);
 }
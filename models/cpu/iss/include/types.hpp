@@ -382,7 +382,7 @@ typedef struct iss_insn_s
     int in_spregs[6];
 
     int latency;
-    std::vector<iss_reg_t>  breakpoints;
+    int nb_breakpoints;     // Number of breakpoints on this instruction, its handlers are patched when non-zero
 
     iss_insn_t *expand_table;
     bool is_macro_op;
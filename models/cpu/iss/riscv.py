@@ -16,6 +16,7 @@
 
 import gvsoc.systree
 import gvsoc.systree as st
+import gvsoc.json_tools as js
 import os.path
 import gvsoc.gui
 import cpu.iss.isa_gen.isa_riscv_gen
@@ -118,6 +119,7 @@ class RiscvCommon(st.Component):
             "cpu/iss/src/regfile.cpp",
             "cpu/iss/src/resource.cpp",
             "cpu/iss/src/trace.cpp",
+            "cpu/iss/src/debug_info.cpp",
             "cpu/iss/src/syscalls.cpp",
             "cpu/iss/src/htif.cpp",
             "cpu/iss/src/mmu.cpp",
@@ -200,6 +202,7 @@ class RiscvCommon(st.Component):
             self.add_c_flags(['-DCONFIG_GVSOC_ISS_HTIF=1'])
 
             for binary in binaries:
+                js.add_loaded_file(binary)
                 with open(binary, 'rb') as file:
                     elffile = ELFFile(file)
                     for section in elffile.iter_sections():
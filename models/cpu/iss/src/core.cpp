@@ -98,8 +98,15 @@ iss_reg_t Core::mret_handle()
 #else
     this->iss.csr.mstatus.mpp = PRIV_M;
 #endif
-    this->iss.irq.irq_enable.set(this->iss.csr.mstatus.mpie);
+#ifdef CONFIG_GVSOC_ISS_PMP
+    // MPP is also used for checking loads and stores when MPRV is set
+    if (this->iss.csr.mstatus.mprv)
+    {
+        this->iss.pmp.flush();
+    }
+#endif
     this->iss.csr.mstatus.mie = this->iss.csr.mstatus.mpie;
+    this->iss.irq.global_enable(this->iss.csr.mstatus.mpie);
     this->iss.csr.mstatus.mpie = 1;
     this->iss.csr.mcause.value = 0;
 
@@ -118,8 +125,8 @@ iss_reg_t Core::sret_handle()
 
     this->mode_set(this->iss.csr.mstatus.spp);
     this->iss.csr.mstatus.spp = PRIV_U;
-    this->iss.irq.irq_enable.set(this->iss.csr.mstatus.spie);
     this->iss.csr.mstatus.sie = this->iss.csr.mstatus.spie;
+    this->iss.irq.global_enable(this->iss.csr.mstatus.spie);
     this->iss.csr.mstatus.spie = 1;
     this->iss.csr.scause.value = 0;
 
@@ -140,6 +147,11 @@ bool Core::mstatus_update(bool is_write, iss_reg_t &value)
 {
     if (is_write)
     {
+    #ifdef CONFIG_GVSOC_ISS_PMP
+        iss_reg_t prev_mprv = this->iss.csr.mstatus.mprv;
+        iss_reg_t prev_mpp = this->iss.csr.mstatus.mpp;
+    #endif
+
     #ifdef CONFIG_GVSOC_ISS_RI5KY
         this->iss.csr.mstatus.value = value;
 
@@ -155,6 +167,14 @@ bool Core::mstatus_update(bool is_write, iss_reg_t &value)
 
         this->iss.timing.stall_insn_dependency_account(4);
         this->iss.irq.global_enable(this->iss.csr.mstatus.mie);
+
+    #ifdef CONFIG_GVSOC_ISS_PMP
+        // Loads and stores are checked with the MPP mode when MPRV is set
+        if (this->iss.csr.mstatus.mprv != prev_mprv || this->iss.csr.mstatus.mpp != prev_mpp)
+        {
+            this->iss.pmp.flush();
+        }
+    #endif
     }
     else
     {
@@ -190,4 +210,9 @@ void Core::mode_set(int mode)
 {
     this->mode = mode;
     this->iss.insn_cache.mode_flush();
+    // Interrupts enabled by the mode may have changed
+    this->iss.irq.pending_update();
+#ifdef CONFIG_GVSOC_ISS_PMP
+    this->iss.pmp.flush();
+#endif
 }
\ No newline at end of file
@@ -117,6 +117,8 @@ void Csr::reset(bool active)
         memset(this->hwloop_regs, 0, sizeof(this->hwloop_regs));
 #endif
     #if defined(ISS_HAS_PERF_COUNTERS)
+        // Events counted with the previous configuration must be accounted first
+        this->iss.timing.pccr_sync();
         this->pcmr = 0;
         this->pcer = 3;
     #endif
@@ -758,6 +760,8 @@ void check_perf_config_change(Iss *iss, unsigned int pcer, unsigned int pcmr)
 
 static bool perfCounters_read(Iss *iss, int reg, iss_reg_t *value)
 {
+    iss->timing.pccr_sync();
+
     if (reg == CSR_PCER)
     {
         *value = iss->csr.pcer;
@@ -786,6 +790,9 @@ static bool perfCounters_read(Iss *iss, int reg, iss_reg_t *value)
 
 static bool perfCounters_write(Iss *iss, int reg, unsigned int value)
 {
+    // Pending events must be accounted with the current configuration before it is modified
+    iss->timing.pccr_sync();
+
     if (reg == CSR_PCER)
     {
         iss->csr.trace.msg("Setting PCER (value: 0x%x)\n", value);
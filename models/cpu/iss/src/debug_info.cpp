@@ -0,0 +1,1007 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <queue>
+#include "cpu/iss/include/debug_info.hpp"
+
+// Maximum distance between 2 PCs so that they can be merged into the same range
+#define DEBUG_INFO_MAX_INSN_SIZE 4
+
+// DWARF constants used by the line table reader
+#define DW_LNS_copy               1
+#define DW_LNS_advance_pc         2
+#define DW_LNS_advance_line       3
+#define DW_LNS_set_file           4
+#define DW_LNS_const_add_pc       8
+#define DW_LNS_fixed_advance_pc   9
+#define DW_LNE_end_sequence       1
+#define DW_LNE_set_address        2
+#define DW_LNCT_path              1
+#define DW_LNCT_directory_index   2
+#define DW_FORM_data2             0x05
+#define DW_FORM_data4             0x06
+#define DW_FORM_data8             0x07
+#define DW_FORM_string            0x08
+#define DW_FORM_block             0x09
+#define DW_FORM_data1             0x0b
+#define DW_FORM_strp              0x0e
+#define DW_FORM_udata             0x0f
+#define DW_FORM_data16            0x1e
+#define DW_FORM_line_strp         0x1f
+
+
+// Function symbol of an ELF binary
+class ElfSymbol
+{
+public:
+    uint64_t addr;
+    uint64_t size;
+    const char *name;
+    // Offset of the name in the string pool, or -1 if not added yet
+    int64_t name_offset;
+};
+
+
+// Sections of an ELF binary needed for the debug information
+class ElfContent
+{
+public:
+    // Return the function containing the address, or NULL if there is none
+    ElfSymbol *symbol_get(uint64_t addr);
+
+    std::vector<ElfSymbol> symbols;
+    uint8_t *debug_line = NULL;
+    uint64_t debug_line_size = 0;
+    uint8_t *debug_line_str = NULL;
+    uint64_t debug_line_str_size = 0;
+    uint8_t *debug_str = NULL;
+    uint64_t debug_str_size = 0;
+};
+
+
+// Bounds-checked reader of DWARF sections. Reading outside the section sets the error flag and
+// returns 0, so that corrupted binaries just stop the parsing.
+class DwarfCursor
+{
+public:
+    DwarfCursor(uint8_t *ptr, uint8_t *end) : ptr(ptr), end(end), error(false) {}
+
+    uint64_t u(int size)
+    {
+        uint64_t value = 0;
+        if (this->end - this->ptr < size)
+        {
+            this->error = true;
+            this->ptr = this->end;
+            return 0;
+        }
+        // DWARF data is little-endian on RISC-V
+        for (int i=0; i<size; i++)
+        {
+            value |= (uint64_t)this->ptr[i] << (i*8);
+        }
+        this->ptr += size;
+        return value;
+    }
+
+    uint64_t uleb()
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (this->ptr < this->end)
+        {
+            uint8_t byte = *this->ptr++;
+            if (shift < 64) value |= (uint64_t)(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) return value;
+        }
+        this->error = true;
+        return 0;
+    }
+
+    int64_t sleb()
+    {
+        int64_t value = 0;
+        int shift = 0;
+        while (this->ptr < this->end)
+        {
+            uint8_t byte = *this->ptr++;
+            if (shift < 64) value |= (int64_t)(byte & 0x7f) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0)
+            {
+                if (shift < 64 && (byte & 0x40)) value |= -((int64_t)1 << shift);
+                return value;
+            }
+        }
+        this->error = true;
+        return 0;
+    }
+
+    const char *str()
+    {
+        const char *result = (const char *)this->ptr;
+        uint8_t *str_end = (uint8_t *)memchr(this->ptr, 0, this->end - this->ptr);
+        if (str_end == NULL)
+        {
+            this->error = true;
+            this->ptr = this->end;
+            return "";
+        }
+        this->ptr = str_end + 1;
+        return result;
+    }
+
+    void skip(uint64_t size)
+    {
+        if ((uint64_t)(this->end - this->ptr) < size)
+        {
+            this->error = true;
+            this->ptr = this->end;
+        }
+        else
+        {
+            this->ptr += size;
+        }
+    }
+
+    uint8_t *ptr;
+    uint8_t *end;
+    bool error;
+};
+
+
+ElfSymbol *ElfContent::symbol_get(uint64_t addr)
+{
+    auto it = std::upper_bound(this->symbols.begin(), this->symbols.end(), addr,
+        [](uint64_t addr, const ElfSymbol &symbol) { return addr < symbol.addr; });
+
+    if (it == this->symbols.begin())
+    {
+        return NULL;
+    }
+
+    it--;
+    if (addr - it->addr >= it->size)
+    {
+        return NULL;
+    }
+
+    return &*it;
+}
+
+
+// Get the function symbols and the debug sections of an ELF binary, for both classes
+template<class Ehdr, class Shdr, class Sym>
+static int elf_content_get(uint8_t *data, size_t size, ElfContent *elf)
+{
+    Ehdr *header = (Ehdr *)data;
+    if (size < sizeof(Ehdr) || header->e_shoff == 0 || header->e_shentsize != sizeof(Shdr) ||
+        header->e_shoff + (uint64_t)header->e_shnum * sizeof(Shdr) > size)
+    {
+        return -1;
+    }
+
+    Shdr *sections = (Shdr *)(data + header->e_shoff);
+    auto section_valid = [&](Shdr *section) {
+        return section->sh_type != SHT_NOBITS && section->sh_offset + section->sh_size <= size;
+    };
+
+    const char *shstrtab = NULL;
+    if (header->e_shstrndx < header->e_shnum && section_valid(&sections[header->e_shstrndx]))
+    {
+        shstrtab = (const char *)data + sections[header->e_shstrndx].sh_offset;
+    }
+
+    for (int i=0; i<header->e_shnum; i++)
+    {
+        Shdr *section = &sections[i];
+        if (!section_valid(section))
+        {
+            continue;
+        }
+
+        if (section->sh_type == SHT_SYMTAB && section->sh_entsize == sizeof(Sym) &&
+            section->sh_link < header->e_shnum && section_valid(&sections[section->sh_link]))
+        {
+            Shdr *strtab = &sections[section->sh_link];
+            const char *names = (const char *)data + strtab->sh_offset;
+            Sym *symbols = (Sym *)(data + section->sh_offset);
+            int nb_symbols = section->sh_size / sizeof(Sym);
+
+            for (int j=0; j<nb_symbols; j++)
+            {
+                Sym *symbol = &symbols[j];
+                if ((symbol->st_info & 0xf) == STT_FUNC && symbol->st_size != 0 &&
+                    symbol->st_shndx != SHN_UNDEF && symbol->st_name < strtab->sh_size &&
+                    memchr(names + symbol->st_name, 0, strtab->sh_size - symbol->st_name))
+                {
+                    elf->symbols.push_back({ symbol->st_value, symbol->st_size,
+                        names + symbol->st_name, -1 });
+                }
+            }
+        }
+        else if (shstrtab && section->sh_name < sections[header->e_shstrndx].sh_size)
+        {
+            const char *name = shstrtab + section->sh_name;
+            if (strcmp(name, ".debug_line") == 0)
+            {
+                elf->debug_line = data + section->sh_offset;
+                elf->debug_line_size = section->sh_size;
+            }
+            else if (strcmp(name, ".debug_line_str") == 0)
+            {
+                elf->debug_line_str = data + section->sh_offset;
+                elf->debug_line_str_size = section->sh_size;
+            }
+            else if (strcmp(name, ".debug_str") == 0)
+            {
+                elf->debug_str = data + section->sh_offset;
+                elf->debug_str_size = section->sh_size;
+            }
+        }
+    }
+
+    std::stable_sort(elf->symbols.begin(), elf->symbols.end(),
+        [](const ElfSymbol &a, const ElfSymbol &b) { return a.addr < b.addr; });
+
+    return 0;
+}
+
+
+// Read an attribute of a DWARF 5 directory or file entry. Only strings and integers are
+// returned, other forms are skipped. Returns false for forms which can not be skipped.
+static bool dwarf_form_read(DwarfCursor *cursor, ElfContent *elf, int form, bool is_64,
+    const char **str, uint64_t *value)
+{
+    switch (form)
+    {
+        case DW_FORM_string:
+            *str = cursor->str();
+            return true;
+
+        case DW_FORM_line_strp:
+        case DW_FORM_strp:
+        {
+            uint64_t offset = cursor->u(is_64 ? 8 : 4);
+            uint8_t *section = form == DW_FORM_strp ? elf->debug_str : elf->debug_line_str;
+            uint64_t size = form == DW_FORM_strp ? elf->debug_str_size : elf->debug_line_str_size;
+            if (section && offset < size && memchr(section + offset, 0, size - offset))
+            {
+                *str = (const char *)section + offset;
+            }
+            return true;
+        }
+
+        case DW_FORM_udata: *value = cursor->uleb(); return true;
+        case DW_FORM_data1: *value = cursor->u(1); return true;
+        case DW_FORM_data2: *value = cursor->u(2); return true;
+        case DW_FORM_data4: *value = cursor->u(4); return true;
+        case DW_FORM_data8: *value = cursor->u(8); return true;
+        case DW_FORM_data16: cursor->skip(16); return true;
+        case DW_FORM_block: cursor->skip(cursor->uleb()); return true;
+    }
+
+    return false;
+}
+
+
+// Read the directory or file table of a DWARF 5 line table header
+static bool dwarf_entries_read(DwarfCursor *cursor, ElfContent *elf, bool is_64,
+    std::vector<std::string> &dirs, std::vector<std::string> *names)
+{
+    int nb_formats = cursor->u(1);
+    std::vector<std::pair<uint64_t, uint64_t>> formats;
+    for (int i=0; i<nb_formats; i++)
+    {
+        uint64_t content = cursor->uleb();
+        uint64_t form = cursor->uleb();
+        formats.push_back({ content, form });
+    }
+
+    uint64_t nb_entries = cursor->uleb();
+    for (uint64_t i=0; i<nb_entries && !cursor->error; i++)
+    {
+        const char *path = "";
+        uint64_t dir_index = 0;
+        for (auto &format: formats)
+        {
+            const char *str = NULL;
+            uint64_t value = 0;
+            if (!dwarf_form_read(cursor, elf, format.second, is_64, &str, &value))
+            {
+                return false;
+            }
+            if (format.first == DW_LNCT_path && str) path = str;
+            else if (format.first == DW_LNCT_directory_index) dir_index = value;
+        }
+
+        if (names == NULL)
+        {
+            dirs.push_back(path);
+        }
+        else if (path[0] != '/' && dir_index < dirs.size() && dirs[dir_index] != "")
+        {
+            names->push_back(dirs[dir_index] + "/" + path);
+        }
+        else
+        {
+            names->push_back(path);
+        }
+    }
+
+    return !cursor->error;
+}
+
+
+DebugInfo::DebugInfo(std::string path, std::string binary)
+    : path(path), binary(binary), loaded(false), load_failed(false), mapped(NULL),
+    mapped_size(0), ranges(NULL), nb_ranges(0), strings(NULL)
+{
+}
+
+
+
+DebugInfo::~DebugInfo()
+{
+    if (this->mapped)
+    {
+        munmap(this->mapped, this->mapped_size);
+    }
+}
+
+
+
+void DebugInfo::set_content(uint8_t *data)
+{
+    Header *header = (Header *)data;
+    this->nb_ranges = header->nb_ranges;
+    this->ranges = (Range *)(data + sizeof(Header));
+    this->strings = (const char *)(this->ranges + header->nb_ranges);
+}
+
+
+
+int DebugInfo::load()
+{
+    // The cache is checked against the file the information is extracted from
+    const char *source = this->binary != "" ? this->binary.c_str() : this->path.c_str();
+
+    struct stat stat_buf;
+    if (stat(source, &stat_buf) < 0)
+    {
+        return -1;
+    }
+
+    int64_t mtime = (int64_t)stat_buf.st_mtim.tv_sec * 1000000000 + stat_buf.st_mtim.tv_nsec;
+    std::string cache_path = this->path + ".cache";
+
+    if (this->map_cache(cache_path, stat_buf.st_size, mtime) == 0)
+    {
+        return 0;
+    }
+
+    std::vector<Range> entries;
+    int error = this->binary != "" ? this->parse_elf(source, entries) :
+        this->parse_text(source, entries);
+    if (error)
+    {
+        return -1;
+    }
+
+    this->build(entries, stat_buf.st_size, mtime);
+    this->write_cache(cache_path);
+
+    return 0;
+}
+
+
+
+int DebugInfo::map_cache(std::string cache_path, uint64_t source_size, int64_t source_mtime)
+{
+    int fd = open(cache_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) < 0 || (size_t)stat_buf.st_size < sizeof(Header))
+    {
+        close(fd);
+        return -1;
+    }
+
+    void *data = mmap(NULL, stat_buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    Header *header = (Header *)data;
+    if (memcmp(header->magic, DEBUG_INFO_MAGIC, sizeof(header->magic)) != 0 ||
+        header->source_size != source_size || header->source_mtime != source_mtime ||
+        sizeof(Header) + (uint64_t)header->nb_ranges * sizeof(Range) + header->strings_size !=
+            (uint64_t)stat_buf.st_size)
+    {
+        munmap(data, stat_buf.st_size);
+        return -1;
+    }
+
+    this->mapped = data;
+    this->mapped_size = stat_buf.st_size;
+    this->set_content((uint8_t *)data);
+
+    return 0;
+}
+
+
+
+uint32_t DebugInfo::string_get(const char *str)
+{
+    auto it = this->build_string_offsets.find(str);
+    if (it != this->build_string_offsets.end())
+    {
+        return it->second;
+    }
+    uint32_t offset = this->build_strings.size();
+    this->build_strings.append(str);
+    this->build_strings.push_back(0);
+    this->build_string_offsets[str] = offset;
+    return offset;
+}
+
+
+
+int DebugInfo::parse_text(const char *path, std::vector<Range> &entries)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return -1;
+    }
+
+    char *line = NULL;
+    size_t len = 0;
+    while (getline(&line, &len, file) != -1)
+    {
+        char *token = strtok(line, " ");
+        char *tokens[5];
+        int index = 0;
+        while (token && index < 5)
+        {
+            tokens[index++] = token;
+            token = strtok(NULL, " ");
+        }
+        if (index == 5 && token == NULL)
+        {
+            Range entry;
+            entry.base = strtoull(tokens[0], NULL, 16);
+            entry.size = 1;
+            entry.func = this->string_get(tokens[1]);
+            entry.inline_func = this->string_get(tokens[2]);
+            entry.file = this->string_get(tokens[3]);
+            entry.line = atoi(tokens[4]);
+            entry.unused = 0;
+            entries.push_back(entry);
+        }
+    }
+    free(line);
+    fclose(file);
+
+    return 0;
+}
+
+
+
+int DebugInfo::parse_elf(const char *path, std::vector<Range> &entries)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) < 0 || (size_t)stat_buf.st_size < EI_NIDENT)
+    {
+        close(fd);
+        return -1;
+    }
+
+    size_t size = stat_buf.st_size;
+    uint8_t *data = (uint8_t *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    ElfContent elf;
+    int error = -1;
+    if (memcmp(data, ELFMAG, SELFMAG) == 0 && data[EI_DATA] == ELFDATA2LSB)
+    {
+        if (data[EI_CLASS] == ELFCLASS32)
+        {
+            error = elf_content_get<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>(data, size, &elf);
+        }
+        else if (data[EI_CLASS] == ELFCLASS64)
+        {
+            error = elf_content_get<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>(data, size, &elf);
+        }
+    }
+
+    if (error == 0)
+    {
+        if (elf.debug_line)
+        {
+            this->parse_debug_line(&elf, entries);
+        }
+
+        // Parts of functions not covered by the line tables, like code compiled without debug
+        // information, still get their function name
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const Range &a, const Range &b) { return a.base < b.base; });
+
+        uint32_t no_file = this->string_get("-");
+        std::vector<Range> gaps;
+        for (ElfSymbol &symbol: elf.symbols)
+        {
+            uint32_t name = this->string_get(symbol.name);
+            uint64_t symbol_end = symbol.addr + symbol.size;
+            uint64_t addr = symbol.addr;
+
+            auto add_gap = [&](uint64_t end) {
+                while (addr < end)
+                {
+                    uint64_t size = std::min(end - addr, (uint64_t)UINT32_MAX);
+                    gaps.push_back({ addr, (uint32_t)size, name, name, no_file, 0, 0 });
+                    addr += size;
+                }
+            };
+
+            // Ranges are not overlapping, so only the one before the first range starting in
+            // the function can cover its start
+            auto it = std::lower_bound(entries.begin(), entries.end(), symbol.addr,
+                [](const Range &range, uint64_t addr) { return range.base < addr; });
+            if (it != entries.begin() && (it - 1)->base + (it - 1)->size > addr)
+            {
+                addr = (it - 1)->base + (it - 1)->size;
+            }
+
+            for (; it != entries.end() && it->base < symbol_end; it++)
+            {
+                add_gap(it->base);
+                addr = std::max(addr, it->base + it->size);
+            }
+            add_gap(symbol_end);
+        }
+
+        entries.insert(entries.end(), gaps.begin(), gaps.end());
+    }
+
+    munmap(data, size);
+
+    return error;
+}
+
+
+
+void DebugInfo::parse_debug_line(ElfContent *elf, std::vector<Range> &entries)
+{
+    DwarfCursor section(elf->debug_line, elf->debug_line + elf->debug_line_size);
+    uint32_t no_func = this->string_get("-");
+
+    // Address, file index and line of the rows of the current sequence
+    struct Row { uint64_t addr; uint64_t file; int64_t line; };
+    std::vector<Row> rows;
+
+    while (section.ptr < section.end && !section.error)
+    {
+        bool is_64 = false;
+        uint64_t unit_length = section.u(4);
+        if (unit_length == 0xffffffff)
+        {
+            is_64 = true;
+            unit_length = section.u(8);
+        }
+
+        if (section.error || unit_length > (uint64_t)(section.end - section.ptr))
+        {
+            return;
+        }
+
+        uint8_t *unit_end = section.ptr + unit_length;
+        DwarfCursor cursor(section.ptr, unit_end);
+        section.ptr = unit_end;
+
+        int version = cursor.u(2);
+        if (version < 2 || version > 5)
+        {
+            continue;
+        }
+
+        if (version >= 5)
+        {
+            // Address size and segment selector size
+            cursor.skip(2);
+        }
+
+        uint64_t header_length = cursor.u(is_64 ? 8 : 4);
+        if (header_length > (uint64_t)(cursor.end - cursor.ptr))
+        {
+            continue;
+        }
+        uint8_t *program = cursor.ptr + header_length;
+
+        int min_insn_length = cursor.u(1);
+        if (version >= 4)
+        {
+            // Maximum operations per instruction, only used by VLIW
+            cursor.skip(1);
+        }
+        bool default_is_stmt = cursor.u(1);
+        (void)default_is_stmt;
+        int line_base = (int8_t)cursor.u(1);
+        int line_range = cursor.u(1);
+        int opcode_base = cursor.u(1);
+
+        if (line_range == 0 || opcode_base == 0)
+        {
+            continue;
+        }
+
+        std::vector<uint8_t> opcode_lengths(opcode_base);
+        for (int i=1; i<opcode_base; i++)
+        {
+            opcode_lengths[i] = cursor.u(1);
+        }
+
+        std::vector<std::string> dirs;
+        std::vector<std::string> names;
+
+        if (version >= 5)
+        {
+            if (!dwarf_entries_read(&cursor, elf, is_64, dirs, NULL) ||
+                !dwarf_entries_read(&cursor, elf, is_64, dirs, &names))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            // Files are numbered from 1 and directory 0 is the compilation directory, which is
+            // only known from the debug info section
+            dirs.push_back("");
+            names.push_back("-");
+
+            while (!cursor.error)
+            {
+                const char *dir = cursor.str();
+                if (dir[0] == 0) break;
+                dirs.push_back(dir);
+            }
+
+            while (!cursor.error)
+            {
+                const char *name = cursor.str();
+                if (name[0] == 0) break;
+                uint64_t dir_index = cursor.uleb();
+                // Modification time and size
+                cursor.uleb();
+                cursor.uleb();
+
+                if (name[0] != '/' && dir_index < dirs.size() && dirs[dir_index] != "")
+                {
+                    names.push_back(dirs[dir_index] + "/" + name);
+                }
+                else
+                {
+                    names.push_back(name);
+                }
+            }
+        }
+
+        if (cursor.error)
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> name_offsets;
+        for (std::string &name: names)
+        {
+            name_offsets.push_back(this->string_get(name.c_str()));
+        }
+
+        cursor.ptr = program;
+
+        uint64_t addr = 0;
+        uint64_t file = 1;
+        int64_t line = 1;
+        rows.clear();
+
+        while (cursor.ptr < cursor.end && !cursor.error)
+        {
+            int opcode = cursor.u(1);
+            bool emit = false;
+
+            if (opcode >= opcode_base)
+            {
+                int adjusted = opcode - opcode_base;
+                addr += (adjusted / line_range) * min_insn_length;
+                line += line_base + adjusted % line_range;
+                emit = true;
+            }
+            else if (opcode == 0)
+            {
+                uint64_t length = cursor.uleb();
+                uint8_t *next = cursor.ptr + length;
+                if (length == 0 || length > (uint64_t)(cursor.end - cursor.ptr))
+                {
+                    break;
+                }
+
+                int sub_opcode = cursor.u(1);
+                if (sub_opcode == DW_LNE_end_sequence)
+                {
+                    rows.push_back({ addr, file, line });
+
+                    // Each row covers the addresses until the next one, the last one just gives
+                    // the end of the sequence
+                    for (size_t i=0; i+1<rows.size(); i++)
+                    {
+                        Row *row = &rows[i];
+                        uint64_t size = rows[i+1].addr - row->addr;
+                        if (size == 0 || size > UINT32_MAX || row->file >= name_offsets.size())
+                        {
+                            continue;
+                        }
+
+                        // Sequences of functions removed by the linker are relocated to 0 or
+                        // -1, skip them if they do not belong to any function
+                        if ((row->addr == 0 || row->addr == (uint64_t)-1) &&
+                            elf->symbols.size() && elf->symbol_get(row->addr) == NULL)
+                        {
+                            break;
+                        }
+
+                        ElfSymbol *symbol = elf->symbol_get(row->addr);
+                        uint32_t func = no_func;
+                        if (symbol)
+                        {
+                            if (symbol->name_offset == -1)
+                            {
+                                symbol->name_offset = this->string_get(symbol->name);
+                            }
+                            func = symbol->name_offset;
+                        }
+
+                        entries.push_back({ row->addr, (uint32_t)size, func, func,
+                            name_offsets[row->file], (int32_t)row->line, 0 });
+                    }
+
+                    rows.clear();
+                    addr = 0;
+                    file = 1;
+                    line = 1;
+                }
+                else if (sub_opcode == DW_LNE_set_address && length <= 9)
+                {
+                    addr = cursor.u(length - 1);
+                }
+
+                cursor.ptr = next;
+            }
+            else if (opcode == DW_LNS_copy)
+            {
+                emit = true;
+            }
+            else if (opcode == DW_LNS_advance_pc)
+            {
+                addr += cursor.uleb() * min_insn_length;
+            }
+            else if (opcode == DW_LNS_advance_line)
+            {
+                line += cursor.sleb();
+            }
+            else if (opcode == DW_LNS_set_file)
+            {
+                file = cursor.uleb();
+            }
+            else if (opcode == DW_LNS_const_add_pc)
+            {
+                addr += ((255 - opcode_base) / line_range) * min_insn_length;
+            }
+            else if (opcode == DW_LNS_fixed_advance_pc)
+            {
+                addr += cursor.u(2);
+            }
+            else
+            {
+                // Other standard opcodes do not change the address, file or line, just skip
+                // their arguments
+                for (int i=0; i<opcode_lengths[opcode]; i++)
+                {
+                    cursor.uleb();
+                }
+            }
+
+            if (emit)
+            {
+                rows.push_back({ addr, file, line });
+            }
+        }
+    }
+}
+
+
+
+void DebugInfo::build(std::vector<Range> &entries, uint64_t source_size, int64_t source_mtime)
+{
+    // Entries may overlap, in which case the last one given for a PC wins, as the lookups
+    // were returning the last inserted information. The address space is split at each entry
+    // boundary and each piece gets the last entry covering it.
+    std::vector<uint32_t> order(entries.size());
+    std::vector<uint64_t> bounds;
+    for (size_t i=0; i<entries.size(); i++)
+    {
+        order[i] = i;
+        bounds.push_back(entries[i].base);
+        bounds.push_back(entries[i].base + entries[i].size);
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&](uint32_t a, uint32_t b) { return entries[a].base < entries[b].base; });
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    // Entries covering the current piece, the last given one on top
+    std::priority_queue<uint32_t> active;
+    size_t next_entry = 0;
+
+    // Merge contiguous PCs having the same information into a single range
+    std::vector<Range> ranges;
+    for (size_t i=0; i + 1<bounds.size(); i++)
+    {
+        uint64_t base = bounds[i];
+        while (next_entry < order.size() && entries[order[next_entry]].base <= base)
+        {
+            active.push(order[next_entry++]);
+        }
+        while (!active.empty() &&
+            entries[active.top()].base + entries[active.top()].size <= base)
+        {
+            active.pop();
+        }
+        if (active.empty())
+        {
+            continue;
+        }
+
+        Range entry = entries[active.top()];
+        entry.base = base;
+        entry.size = bounds[i + 1] - base;
+
+        if (ranges.size() > 0)
+        {
+            Range &last = ranges.back();
+            uint64_t last_end = last.base + last.size;
+            if (entry.base - (last_end - 1) <= DEBUG_INFO_MAX_INSN_SIZE &&
+                entry.func == last.func && entry.inline_func == last.inline_func &&
+                entry.file == last.file && entry.line == last.line &&
+                entry.base + entry.size - last.base <= UINT32_MAX)
+            {
+                last.size = entry.base + entry.size - last.base;
+                continue;
+            }
+        }
+        ranges.push_back(entry);
+    }
+
+    std::string &strings = this->build_strings;
+
+    Header header;
+    memcpy(header.magic, DEBUG_INFO_MAGIC, sizeof(header.magic));
+    header.source_size = source_size;
+    header.source_mtime = source_mtime;
+    header.nb_ranges = ranges.size();
+    header.strings_size = strings.size();
+
+    this->buffer.resize(sizeof(Header) + ranges.size() * sizeof(Range) + strings.size());
+    uint8_t *data = this->buffer.data();
+    memcpy(data, &header, sizeof(Header));
+    memcpy(data + sizeof(Header), ranges.data(), ranges.size() * sizeof(Range));
+    memcpy(data + sizeof(Header) + ranges.size() * sizeof(Range), strings.data(), strings.size());
+
+    this->set_content(data);
+
+    this->build_strings.clear();
+    this->build_string_offsets.clear();
+}
+
+
+
+void DebugInfo::write_cache(std::string cache_path)
+{
+    // Write to a temporary file and rename it, so that another simulation reading the cache
+    // at the same time never sees a partial file. Failures are not an issue, the content
+    // is still available from the buffer.
+    std::string tmp_path = cache_path + "." + std::to_string(getpid());
+    FILE *file = fopen(tmp_path.c_str(), "wb");
+    if (file == NULL)
+    {
+        return;
+    }
+
+    bool failed = fwrite(this->buffer.data(), 1, this->buffer.size(), file) != this->buffer.size();
+    failed |= fclose(file) != 0;
+
+    if (failed || rename(tmp_path.c_str(), cache_path.c_str()) < 0)
+    {
+        unlink(tmp_path.c_str());
+    }
+}
+
+
+
+int DebugInfo::lookup(uint64_t addr, const char **func, const char **inline_func,
+    const char **file, int *line)
+{
+    if (!this->loaded)
+    {
+        this->loaded = true;
+        this->load_failed = this->load() != 0;
+    }
+
+    if (this->load_failed)
+    {
+        return -1;
+    }
+
+    Range *end = this->ranges + this->nb_ranges;
+
+    // Find the last range starting before or at the address
+    Range *range = std::upper_bound(this->ranges, end, addr,
+        [](uint64_t addr, const Range &range) { return addr < range.base; });
+
+    if (range == this->ranges)
+    {
+        return -1;
+    }
+
+    range--;
+    if (addr - range->base >= range->size)
+    {
+        return -1;
+    }
+
+    *func = this->strings + range->func;
+    *inline_func = this->strings + range->inline_func;
+    *file = this->strings + range->file;
+    *line = range->line;
+
+    return 0;
+}
@@ -218,7 +218,7 @@ void Exec::hwloop_set_end(int index, iss_reg_t pc)
     this->hwloop_end_insn[index] = pc;
 
     iss_reg_t cache_index;
-    iss_insn_t *insn = this->iss.insn_cache.get_insn(pc, cache_index);
+    iss_insn_t *insn = this->iss.insn_cache.get_insn(pc, cache_index, false);
 
     if (insn != NULL && this->iss.insn_cache.insn_is_decoded(insn))
     {
@@ -27,6 +27,9 @@
 Gdbserver::Gdbserver(Iss &iss)
     : iss(iss)
 {
+    this->nb_watchpoints = 0;
+    memset(this->write_watchpoint_pages, 0, sizeof(this->write_watchpoint_pages));
+    memset(this->read_watchpoint_pages, 0, sizeof(this->read_watchpoint_pages));
 }
 
 
@@ -217,43 +220,181 @@ int Gdbserver::gdbserver_state()
 
 
 
-static inline iss_reg_t breakpoint_check_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
+BreakpointSet::BreakpointSet()
 {
-    if (std::count(insn->breakpoints.begin(), insn->breakpoints.end(), pc) > 0)
+    this->nb_entries = 0;
+    this->nb_deleted = 0;
+    this->rehash(4);
+}
+
+
+
+void BreakpointSet::rehash(int bits)
+{
+    std::vector<iss_addr_t> keys = std::move(this->keys);
+    std::vector<uint8_t> states = std::move(this->states);
+
+    this->bits = bits;
+    this->keys.assign(1ULL << bits, 0);
+    this->states.assign(1ULL << bits, SLOT_EMPTY);
+    this->nb_entries = 0;
+    this->nb_deleted = 0;
+
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        if (states[i] == SLOT_USED)
+        {
+            this->insert(keys[i]);
+        }
+    }
+}
+
+
+
+bool BreakpointSet::insert(iss_addr_t addr)
+{
+    if (this->contains(addr))
+    {
+        return false;
+    }
+
+    // Keep the table at most half full, including deleted slots, so that probing sequences
+    // stay short.
+    if ((this->nb_entries + this->nb_deleted + 1) * 2 > (1 << this->bits))
+    {
+        int bits = this->bits;
+        while ((this->nb_entries + 1) * 2 > (1 << bits))
+        {
+            bits++;
+        }
+        this->rehash(bits);
+    }
+
+    uint64_t mask = (1ULL << this->bits) - 1;
+    uint64_t index = this->slot_index(addr);
+    while (this->states[index] == SLOT_USED)
+    {
+        index = (index + 1) & mask;
+    }
+
+    if (this->states[index] == SLOT_DELETED)
+    {
+        this->nb_deleted--;
+    }
+    this->states[index] = SLOT_USED;
+    this->keys[index] = addr;
+    this->nb_entries++;
+
+    return true;
+}
+
+
+
+bool BreakpointSet::remove(iss_addr_t addr)
+{
+    uint64_t mask = (1ULL << this->bits) - 1;
+    for (uint64_t index = this->slot_index(addr);; index = (index + 1) & mask)
+    {
+        uint8_t state = this->states[index];
+        if (state == SLOT_EMPTY)
+        {
+            return false;
+        }
+        if (state == SLOT_USED && this->keys[index] == addr)
+        {
+            // Slot is marked deleted rather than empty to not break probing sequences of
+            // other addresses.
+            this->states[index] = SLOT_DELETED;
+            this->nb_entries--;
+            this->nb_deleted++;
+            return true;
+        }
+    }
+}
+
+
+
+std::vector<iss_addr_t> BreakpointSet::get_all()
+{
+    std::vector<iss_addr_t> result;
+    for (size_t i = 0; i < this->states.size(); i++)
+    {
+        if (this->states[i] == SLOT_USED)
+        {
+            result.push_back(this->keys[i]);
+        }
+    }
+    return result;
+}
+
+
+
+static inline bool breakpoint_check_hit(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
+{
+    // The stub is only installed on instructions having a breakpoint, but the instruction
+    // may be reached through several virtual addresses, so the pc must still be checked.
+    if (iss->gdbserver.breakpoints.contains(pc))
     {
         iss->exec.stalled_inc();
         iss->exec.halted.set(true);
         iss->gdbserver.gdbserver->signal(&iss->gdbserver, vp::Gdbserver_engine::SIGNAL_TRAP, "hwbreak");
+        return true;
+    }
+
+    return false;
+}
+
+
+
+static iss_reg_t breakpoint_check_exec(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
+{
+    if (breakpoint_check_hit(iss, insn, pc))
+    {
         return pc;
     }
-    else
+
+    return insn->breakpoint_saved_handler(iss, insn, pc);
+}
+
+
+
+static iss_reg_t breakpoint_check_exec_fast(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
+{
+    if (breakpoint_check_hit(iss, insn, pc))
     {
-        return iss->exec.insn_exec(insn, pc);
+        return pc;
     }
+
+    return insn->breakpoint_saved_fast_handler(iss, insn, pc);
 }
 
 
 
 void Gdbserver::breakpoint_stub_insert(iss_insn_t *insn, iss_reg_t pc)
 {
-    if (insn->breakpoints.size() == 0)
+    if (insn->nb_breakpoints == 0)
     {
         insn->breakpoint_saved_handler = insn->handler;
         insn->breakpoint_saved_fast_handler = insn->fast_handler;
         insn->handler = breakpoint_check_exec;
-        insn->fast_handler = breakpoint_check_exec;
+        insn->fast_handler = breakpoint_check_exec_fast;
     }
 
-    insn->breakpoints.push_back(pc);
+    insn->nb_breakpoints++;
 }
 
 
 
 void Gdbserver::breakpoint_stub_remove(iss_insn_t *insn, iss_reg_t pc)
 {
-    insn->breakpoints.erase(std::remove(insn->breakpoints.begin(), insn->breakpoints.end(), pc), insn->breakpoints.end());
+    if (insn->nb_breakpoints == 0)
+    {
+        return;
+    }
+
+    insn->nb_breakpoints--;
 
-    if (insn->breakpoints.size() == 0)
+    if (insn->nb_breakpoints == 0)
     {
         insn->handler = insn->breakpoint_saved_handler;
         insn->fast_handler = insn->breakpoint_saved_fast_handler;
@@ -264,21 +405,16 @@ void Gdbserver::breakpoint_stub_remove(iss_insn_t *insn, iss_reg_t pc)
 
 bool Gdbserver::breakpoint_check_pc(iss_addr_t pc)
 {
-    for (auto x: this->breakpoints)
-    {
-        if (x == pc)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return this->breakpoints.contains(pc);
 }
 
 
 
 void Gdbserver::decode_insn(iss_insn_t *insn, iss_addr_t pc)
 {
+    // The handlers have just been set by the decoder, any previous stub is gone
+    insn->nb_breakpoints = 0;
+
     if (this->breakpoint_check_pc(pc))
     {
         this->breakpoint_stub_insert(insn, pc);
@@ -296,7 +432,7 @@ void Gdbserver::enable_breakpoint(iss_addr_t addr)
     // If the cache returns NULL, it means it is currently translating the virtual address,
     // which means it is not decoded yet.
     iss_reg_t index;
-    iss_insn_t *insn = this->iss.insn_cache.get_insn(addr, index);
+    iss_insn_t *insn = this->iss.insn_cache.get_insn(addr, index, false);
 
     if (insn != NULL && this->iss.insn_cache.insn_is_decoded(insn))
     {
@@ -309,8 +445,8 @@ void Gdbserver::enable_breakpoint(iss_addr_t addr)
 void Gdbserver::disable_breakpoint(iss_addr_t addr)
 {
     iss_reg_t index;
-    iss_insn_t *insn = this->iss.insn_cache.get_insn(addr, index);
-    if (this->iss.insn_cache.insn_is_decoded(insn))
+    iss_insn_t *insn = this->iss.insn_cache.get_insn(addr, index, false);
+    if (insn != NULL && this->iss.insn_cache.insn_is_decoded(insn))
     {
         this->breakpoint_stub_remove(insn, addr);
     }
@@ -320,7 +456,7 @@ void Gdbserver::disable_breakpoint(iss_addr_t addr)
 
 void Gdbserver::enable_all_breakpoints()
 {
-    for (auto x: this->breakpoints)
+    for (auto x: this->breakpoints.get_all())
     {
         this->enable_breakpoint(x);
     }
@@ -332,9 +468,11 @@ void Gdbserver::gdbserver_breakpoint_insert(uint64_t addr)
 {
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Inserting breakpoint (addr: 0x%x)\n", addr);
 
-    this->breakpoints.push_back((iss_addr_t)addr);
-
-    this->enable_breakpoint((iss_addr_t)addr);
+    // Inserting the same breakpoint twice must not install the stub twice
+    if (this->breakpoints.insert((iss_addr_t)addr))
+    {
+        this->enable_breakpoint((iss_addr_t)addr);
+    }
 }
 
 
@@ -343,14 +481,35 @@ void Gdbserver::gdbserver_breakpoint_remove(uint64_t addr)
 {
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Removing breakpoint (addr: 0x%x)\n", addr);
 
-    this->breakpoints.remove(addr);
+    if (this->breakpoints.remove((iss_addr_t)addr))
+    {
+        this->disable_breakpoint((iss_addr_t)addr);
+    }
+}
+
+
+
+void Gdbserver::watchpoint_pages_update(bool is_write, iss_addr_t addr, int size, int incr)
+{
+    uint16_t *pages = is_write ? this->write_watchpoint_pages : this->read_watchpoint_pages;
+    iss_addr_t first = addr >> GDBSERVER_WATCHPOINT_PAGE_BITS;
+    iss_addr_t last = (addr + size - 1) >> GDBSERVER_WATCHPOINT_PAGE_BITS;
+
+    // Big watchpoints may wrap around the table, just tag each entry once in this case.
+    if (last - first >= GDBSERVER_WATCHPOINT_TABLE_SIZE)
+    {
+        last = first + GDBSERVER_WATCHPOINT_TABLE_SIZE - 1;
+    }
 
-    this->disable_breakpoint((iss_addr_t)addr);
+    for (iss_addr_t page = first; page <= last; page++)
+    {
+        pages[page & (GDBSERVER_WATCHPOINT_TABLE_SIZE - 1)] += incr;
+    }
 }
 
 
 
-bool Gdbserver::watchpoint_check(bool is_write, iss_addr_t addr, int size)
+bool Gdbserver::watchpoint_check_slow(bool is_write, iss_addr_t addr, int size)
 {
     std::list<Watchpoint *> &watchpoints = is_write ? this->write_watchpoints : this->read_watchpoints;
     for (auto wp: watchpoints)
@@ -379,6 +538,8 @@ void Gdbserver::gdbserver_watchpoint_insert(bool is_write, uint64_t addr, int si
 
     std::list<Watchpoint *> &watchpoints = is_write ? this->write_watchpoints : this->read_watchpoints;
     watchpoints.push_back(new Watchpoint(addr, size));
+    this->watchpoint_pages_update(is_write, addr, size, 1);
+    this->nb_watchpoints++;
 }
 
 
@@ -395,6 +556,9 @@ void Gdbserver::gdbserver_watchpoint_remove(bool is_write, uint64_t addr, int si
     {
         if (addr + size >= (*it)->addr && addr < (*it)->addr + (*it)->size)
         {
+            this->watchpoint_pages_update(is_write, (*it)->addr, (*it)->size, -1);
+            this->nb_watchpoints--;
+            delete *it;
             it = watchpoints.erase(it);
         }
         else
@@ -432,11 +596,14 @@ void Gdbserver::handle_pending_io_access()
     {
         vp::IoReq *req = &this->io_req;
 
-        // Compute the size of the request since the core can only do aligned accesses of its
-        // register width.
+        // Memory accesses from gdb are first done by blocks, without crossing block
+        // boundaries, so that loading or dumping big areas only takes a few requests.
+        // If a block access is rejected, which happens for targets which can only do aligned
+        // accesses of the register width, the rest of the access is done this way.
         iss_addr_t addr = this->io_pending_addr;
-        iss_addr_t addr_aligned = addr & ~(ISS_REG_WIDTH / 8 - 1);
-        int size = addr_aligned + ISS_REG_WIDTH/8 - addr;
+        int chunk_size = this->io_pending_word_access ? ISS_REG_WIDTH / 8 : GDBSERVER_IO_BLOCK_SIZE;
+        iss_addr_t addr_aligned = addr & ~((iss_addr_t)chunk_size - 1);
+        int size = addr_aligned + chunk_size - addr;
         if (size > this->io_pending_size)
         {
             size = this->io_pending_size;
@@ -465,6 +632,16 @@ void Gdbserver::handle_pending_io_access()
             // we don't enqueue another request before the latency of this one is over.
             this->event->enqueue(this->io_req.get_latency() + 1);
         }
+        else if (err == vp::IO_REQ_INVALID && !this->io_pending_word_access)
+        {
+            // Retry the same access with register-width accesses
+            this->trace.msg(vp::Trace::LEVEL_DEBUG, "Block access rejected, switching to word accesses\n");
+            this->io_pending_data -= size;
+            this->io_pending_size += size;
+            this->io_pending_addr -= size;
+            this->io_pending_word_access = true;
+            this->handle_pending_io_access();
+        }
         else if (err == vp::IO_REQ_INVALID)
         {
             // Stop here if we got an error
@@ -505,6 +682,7 @@ int Gdbserver::gdbserver_io_access(uint64_t addr, int size, uint8_t *data, bool
     this->io_pending_size = size;
     this->io_pending_data = data;
     this->io_pending_is_write = is_write;
+    this->io_pending_word_access = false;
     this->waiting_io_response = true;
 
     // Trigger the first access, with engine locked, since we come from an external thread
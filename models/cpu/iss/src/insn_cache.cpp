@@ -104,7 +104,7 @@ InsnPage *InsnCache::page_get(iss_reg_t paddr)
 
 
 
-iss_insn_t *InsnCache::get_insn_from_cache(iss_reg_t vaddr, iss_reg_t &index)
+iss_insn_t *InsnCache::get_insn_from_cache(iss_reg_t vaddr, iss_reg_t &index, bool is_fetch)
 {
     iss_reg_t paddr;
 
@@ -117,6 +117,23 @@ iss_insn_t *InsnCache::get_insn_from_cache(iss_reg_t vaddr, iss_reg_t &index)
     paddr = vaddr;
 #endif
 
+#ifdef CONFIG_GVSOC_ISS_PMP
+    // The page becomes the current one, which skips PMP checks for the next instructions, only
+    // if PMP allows fetching all of it. Otherwise instructions of this page are checked one by
+    // one each time they are executed.
+    if (!this->iss.pmp.insn_page_allowed(paddr))
+    {
+        if (is_fetch && this->iss.pmp.insn_check(paddr, 2))
+        {
+            return NULL;
+        }
+
+        this->current_insn_page_base = -1;
+        index = (vaddr >> 1) & INSN_PAGE_MASK;
+        return &this->page_get(paddr)->insns[index];
+    }
+#endif
+
     this->current_insn_page = this->page_get(paddr);
     this->current_insn_page_base = (vaddr >> INSN_PAGE_BITS) << INSN_PAGE_BITS;
 
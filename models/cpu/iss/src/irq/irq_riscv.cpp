@@ -67,6 +67,8 @@ void Irq::reset(bool active)
         this->irq_enable.set(0);
         this->req_irq = -1;
         this->req_debug = false;
+        this->enabled_interrupts = 0;
+        this->enabled_interrupts_mode = PRIV_M;
         this->debug_handler = this->iss.exception.debug_handler_addr;
     }
     else
@@ -114,7 +116,16 @@ void Irq::sei_sync(vp::Block *__this, bool value)
 
 bool Irq::mideleg_access(bool is_write, iss_reg_t &value)
 {
-    return true;
+    if (is_write)
+    {
+        this->iss.csr.mideleg.value = value;
+        this->pending_update();
+    }
+    else
+    {
+        value = this->iss.csr.mideleg.value;
+    }
+    return false;
 }
 
 bool Irq::mip_access(bool is_write, iss_reg_t &value)
@@ -235,20 +246,50 @@ void Irq::wfi_handle()
 
 void Irq::check_interrupts()
 {
+    this->pending_update();
+
+    // Wfi ends as soon as one interrupt is pending, even if interrupts are globally disabled
     iss_reg_t pending_interrupts = this->iss.csr.mie.value & this->iss.csr.mip.value;
 
-    if (pending_interrupts && !this->iss.exec.irq_locked)
+    if (pending_interrupts && !this->iss.exec.irq_locked && this->iss.exec.wfi.get())
     {
-        this->iss.exec.switch_to_full_mode();
+        this->iss.exec.wfi.set(false);
+        this->iss.exec.busy_enter();
+        this->iss.exec.stalled_dec();
+        this->iss.exec.insn_terminate();
+    }
+}
+
+void Irq::pending_update()
+{
+    iss_reg_t pending_interrupts = this->iss.csr.mie.value & this->iss.csr.mip.value;
+    int mode = this->iss.core.mode_get();
+
+    // First check if the interrupt is handled in M mode
+    int next_mode = PRIV_M;
+    iss_reg_t enabled_interrupts = pending_interrupts & ~this->iss.csr.mideleg.value;
+    bool m_irq_enabled = (mode == PRIV_M && this->iss.csr.mstatus.mie) || mode < PRIV_M;
 
-        if (this->iss.exec.wfi.get())
+    if (!enabled_interrupts || !m_irq_enabled)
+    {
+        // Otherwise, check if it is handled in S mode
+        next_mode = PRIV_S;
+        enabled_interrupts = pending_interrupts & this->iss.csr.mideleg.value;
+        bool s_irq_enabled = (mode == PRIV_S && this->iss.csr.mstatus.sie) || mode < PRIV_S;
+
+        if (!s_irq_enabled)
         {
-            this->iss.exec.wfi.set(false);
-            this->iss.exec.busy_enter();
-            this->iss.exec.stalled_dec();
-            this->iss.exec.insn_terminate();
+            enabled_interrupts = 0;
         }
     }
+
+    this->enabled_interrupts = enabled_interrupts;
+    this->enabled_interrupts_mode = next_mode;
+
+    if (enabled_interrupts && !this->iss.exec.irq_locked)
+    {
+        this->iss.exec.switch_to_full_mode();
+    }
 }
 
 int Irq::check()
@@ -265,96 +306,75 @@ int Irq::check()
     }
     else
     {
-        iss_reg_t pending_interrupts = this->iss.csr.mie.value & this->iss.csr.mip.value;
+        // The mask is kept up to date by pending_update, nothing to do in the common case
+        iss_reg_t enabled_interrupts = this->enabled_interrupts;
 
-        if (pending_interrupts)
+        if (enabled_interrupts)
         {
-            int next_mode = PRIV_M;
-
-            // First check if the interrupt is handled in M mode
-            iss_reg_t enabled_interrupts = pending_interrupts & ~this->iss.csr.mideleg.value;
-            bool m_irq_enabled = (this->iss.core.mode_get() == PRIV_M && this->iss.csr.mstatus.mie) ||
-                this->iss.core.mode_get() < PRIV_M;
+            int next_mode = this->enabled_interrupts_mode;
 
-            if (!enabled_interrupts || !m_irq_enabled)
+            int irq;
+            if ((enabled_interrupts >> 11) & 1)
+            {
+                irq = 11;
+            }
+            else if ((enabled_interrupts >> 3) & 1)
+            {
+                irq = 3;
+            }
+            else if ((enabled_interrupts >> 7) & 1)
+            {
+                irq = 7;
+            }
+            else if ((enabled_interrupts >> 9) & 1)
+            {
+                irq = 9;
+            }
+            else if ((enabled_interrupts >> 1) & 1)
+            {
+                irq = 1;
+            }
+            else if ((enabled_interrupts >> 5) & 1)
+            {
+                irq = 5;
+            }
+            else
             {
-                // Otherwise, check if it is handled in S mode
-                next_mode = PRIV_S;
-                enabled_interrupts = pending_interrupts & this->iss.csr.mideleg.value;
-                bool s_irq_enabled = (this->iss.core.mode_get() == PRIV_S && this->iss.csr.mstatus.sie) ||
-                    this->iss.core.mode_get() < PRIV_S;
-
-                if (!s_irq_enabled)
-                {
-                    enabled_interrupts = 0;
-                }
+                irq = ffs(enabled_interrupts) - 1;
             }
 
-            if (enabled_interrupts)
+            this->trace.msg(vp::Trace::LEVEL_TRACE, "Handling IRQ (irq: %d)\n", irq);
+
+            this->iss.exec.interrupt_taken();
+            this->iss.csr.mepc.value = this->iss.exec.current_insn;
+            this->iss.csr.mstatus.mpie = this->irq_enable.get();
+            this->iss.csr.mstatus.mie = 0;
+
+            if (next_mode == PRIV_M)
             {
-                int irq;
-                if ((enabled_interrupts >> 11) & 1)
-                {
-                    irq = 11;
-                }
-                else if ((enabled_interrupts >> 3) & 1)
-                {
-                    irq = 3;
-                }
-                else if ((enabled_interrupts >> 7) & 1)
-                {
-                    irq = 7;
-                }
-                else if ((enabled_interrupts >> 9) & 1)
-                {
-                    irq = 9;
-                }
-                else if ((enabled_interrupts >> 1) & 1)
-                {
-                    irq = 1;
-                }
-                else if ((enabled_interrupts >> 5) & 1)
-                {
-                    irq = 5;
-                }
-                else
-                {
-                    irq = ffs(enabled_interrupts) - 1;
-                }
-
-                this->trace.msg(vp::Trace::LEVEL_TRACE, "Handling IRQ (irq: %d)\n", irq);
-
-                this->iss.exec.interrupt_taken();
                 this->iss.csr.mepc.value = this->iss.exec.current_insn;
-                this->iss.csr.mstatus.mpie = this->irq_enable.get();
                 this->iss.csr.mstatus.mie = 0;
-
-                if (next_mode == PRIV_M)
-                {
-                    this->iss.csr.mepc.value = this->iss.exec.current_insn;
-                    this->iss.csr.mstatus.mie = 0;
-                    this->iss.csr.mstatus.mpie = this->iss.irq.irq_enable.get();
-                    this->iss.csr.mstatus.mpp = this->iss.core.mode_get();
-                    this->iss.exec.current_insn = this->iss.csr.mtvec.value;
-                    this->iss.csr.mcause.value = (1ULL << (ISS_REG_WIDTH - 1)) | (unsigned int)irq;
-                }
-                else
-                {
-                    this->iss.csr.sepc.value = this->iss.exec.current_insn;
-                    this->iss.csr.mstatus.sie = 0;
-                    this->iss.csr.mstatus.spie = this->iss.irq.irq_enable.get();
-                    this->iss.csr.mstatus.spp = this->iss.core.mode_get();
-                    this->iss.exec.current_insn = this->iss.csr.stvec.value;
-                    this->iss.csr.scause.value = (1ULL << (ISS_REG_WIDTH - 1)) | (unsigned int)irq;
-                }
-                this->iss.core.mode_set(next_mode);
-
-                this->irq_enable.set(0);
-
-                this->iss.timing.stall_insn_dependency_account(4);
-
-                return 1;
+                this->iss.csr.mstatus.mpie = this->iss.irq.irq_enable.get();
+                this->iss.csr.mstatus.mpp = this->iss.core.mode_get();
+                this->iss.exec.current_insn = this->iss.csr.mtvec.value;
+                this->iss.csr.mcause.value = (1ULL << (ISS_REG_WIDTH - 1)) | (unsigned int)irq;
             }
+            else
+            {
+                this->iss.csr.sepc.value = this->iss.exec.current_insn;
+                this->iss.csr.mstatus.sie = 0;
+                this->iss.csr.mstatus.spie = this->iss.irq.irq_enable.get();
+                this->iss.csr.mstatus.spp = this->iss.core.mode_get();
+                this->iss.exec.current_insn = this->iss.csr.stvec.value;
+                this->iss.csr.scause.value = (1ULL << (ISS_REG_WIDTH - 1)) | (unsigned int)irq;
+            }
+            this->iss.core.mode_set(next_mode);
+
+            this->irq_enable.set(0);
+
+            this->iss.timing.stall_insn_dependency_account(4);
+
+            return 1;
         }
     }
 
@@ -41,6 +41,13 @@ void IssWrapper::start()
 
 
 
+void IssWrapper::stop()
+{
+    this->iss.lsu.stop();
+}
+
+
+
 void IssWrapper::reset(bool active)
 {
     this->iss.prefetcher.reset(active);
@@ -225,6 +225,14 @@ void Lsu::build()
         this->memory_end = this->memory_start +
             this->iss.top.get_js_config()->get("memory_size")->get_int();
     }
+
+    this->heatmap = new vp::MemHeatmap(this->iss.top, "lsu");
+#ifdef CONFIG_GVSOC_ISS_MEMORY
+    if (this->memory_start != (iss_addr_t)-1)
+    {
+        this->heatmap->init(this->memory_start, this->memory_end - this->memory_start);
+    }
+#endif
 }
 
 void Lsu::start()
@@ -234,6 +242,11 @@ void Lsu::start()
 #endif
 }
 
+void Lsu::stop()
+{
+    this->heatmap->dump();
+}
+
 void Lsu::store_resume(Lsu *lsu)
 {
     // For now we don't have to do anything as the register was written directly
@@ -317,6 +330,12 @@ void Lsu::atomic(iss_insn_t *insn, iss_addr_t addr, int size, int reg_in, int re
         {
             return;
         }
+#ifdef CONFIG_GVSOC_ISS_PMP
+        if (this->iss.pmp.load_check(phys_addr, size))
+        {
+            return;
+        }
+#endif
     }
     else
     {
@@ -325,6 +344,12 @@ void Lsu::atomic(iss_insn_t *insn, iss_addr_t addr, int size, int reg_in, int re
         {
             return;
         }
+#ifdef CONFIG_GVSOC_ISS_PMP
+        if (this->iss.pmp.store_check(phys_addr, size))
+        {
+            return;
+        }
+#endif
     }
 
     req->init();
@@ -21,10 +21,16 @@
 
 #include "cpu/iss/include/iss.hpp"
 
-static inline iss_reg_t get_field(iss_reg_t field, int bit, int width)
-{
-    return (field >> bit) & ((1 << width) - 1);
-}
+#define PMP_MODE_OFF   0
+#define PMP_MODE_TOR   1
+#define PMP_MODE_NA4   2
+#define PMP_MODE_NAPOT 3
+
+#if ISS_REG_WIDTH == 64
+#define PMP_ADDR_MASK ((1ULL << 54) - 1)
+#else
+#define PMP_ADDR_MASK ((iss_reg_t)-1)
+#endif
 
 Pmp::Pmp(Iss &iss)
 : iss(iss)
@@ -34,55 +40,305 @@ Pmp::Pmp(Iss &iss)
 void Pmp::build()
 {
     this->iss.top.traces.new_trace("pmp", &this->trace, vp::DEBUG);
+
+#if defined(CONFIG_GVSOC_ISS_PMP)
+    // Each pmpcfg register contains the configuration of 4 entries on 32-bit cores. On 64-bit cores
+    // only even registers are used and they contain 8 entries.
+    for (int i=0; i<CONFIG_GVSOC_ISS_PMP_NB_ENTRIES/4; i++)
+    {
+        this->iss.csr.pmpcfg[i].register_callback(std::bind(&Pmp::pmpcfg_update, this, i,
+            std::placeholders::_1, std::placeholders::_2));
+    }
+    for (int i=0; i<CONFIG_GVSOC_ISS_PMP_NB_ENTRIES; i++)
+    {
+        this->iss.csr.pmpaddr[i].register_callback(std::bind(&Pmp::pmpaddr_update, this, i,
+            std::placeholders::_1, std::placeholders::_2));
+    }
+#endif
 }
 
 void Pmp::reset(bool active)
 {
-    for (int i=0; i<16; i++)
+    for (int i=0; i<CONFIG_GVSOC_ISS_PMP_NB_ENTRIES; i++)
     {
         this->entry[i].value = 0;
+        this->entry_addr[i] = 0;
+        this->region_update(i);
     }
+
+    this->flush();
 }
 
-bool Pmp::pmpcfg_read(iss_reg_t *value, int id)
+void Pmp::flush()
 {
-    iss_reg_t val = 0;
-    for (int i=0; i<ISS_REG_WIDTH/8; i++)
+    for (int i=0; i<PMP_CACHE_NB_ENTRIES; i++)
     {
-        val |= this->entry[i].value << (i*8);
+        this->cache_insn_tag[i] = -1;
+        this->cache_load_tag[i] = -1;
+        this->cache_store_tag[i] = -1;
     }
-    return false;
+
+    // The instruction cache only checks fetches when it switches to another page
+    this->iss.insn_cache.mode_flush();
 }
 
-bool Pmp::pmpcfg_write(iss_reg_t value, int id)
+bool Pmp::pmpcfg_update(int id, bool is_write, iss_reg_t &value)
 {
-    for (int i=0; i<ISS_REG_WIDTH/8; i++)
+#if ISS_REG_WIDTH == 64
+    if (id & 1)
+    {
+        if (!is_write)
+        {
+            value = 0;
+        }
+        return false;
+    }
+#endif
+
+    int first_entry = id * 4;
+
+    if (is_write)
     {
-        this->entry_cfg_set(i, (value >> (i*8)) & 0xFF);
+        for (int i=0; i<ISS_REG_WIDTH/8; i++)
+        {
+            this->entry_cfg_set(first_entry + i, (value >> (i*8)) & 0xFF);
+        }
+        this->flush();
     }
+    else
+    {
+        value = 0;
+        for (int i=0; i<ISS_REG_WIDTH/8 && first_entry + i < CONFIG_GVSOC_ISS_PMP_NB_ENTRIES; i++)
+        {
+            value |= (iss_reg_t)this->entry[first_entry + i].value << (i*8);
+        }
+    }
+
     return false;
 }
 
-bool Pmp::pmpaddr_read(iss_reg_t *value, int id)
+bool Pmp::pmpaddr_update(int id, bool is_write, iss_reg_t &value)
 {
+    if (is_write)
+    {
+        this->entry_addr_set(id, value);
+        this->flush();
+    }
+    else
+    {
+        value = this->entry_addr[id];
+    }
+
     return false;
 }
 
-bool Pmp::pmpaddr_write(iss_reg_t value, int id)
+void Pmp::entry_cfg_set(int id, uint8_t config)
+{
+    if (id < CONFIG_GVSOC_ISS_PMP_NB_ENTRIES)
+    {
+        PmpEntry *entry = &this->entry[id];
+
+        if (entry->L)
+        {
+            this->trace.msg(vp::Trace::LEVEL_DEBUG, "Ignoring write to locked entry (id: %d)\n", id);
+            return;
+        }
+
+        entry->value = config & 0x9F;
+
+        // W without R is reserved, keep the entry in a legal state
+        if (entry->W && !entry->R)
+        {
+            entry->W = 0;
+        }
+
+        this->region_update(id);
+
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Setting entry (id: %d, R: %d, W: %d, X: %d, L: %d, mode: %s)\n",
+            id, entry->R, entry->W, entry->X, entry->L, entry->get_mode_name().c_str());
+    }
+}
+
+void Pmp::entry_addr_set(int id, iss_reg_t addr)
 {
+    // The address is also locked if the next entry is a locked TOR entry, since it gives the
+    // bottom of its region
+    if (this->entry[id].L ||
+        (id + 1 < CONFIG_GVSOC_ISS_PMP_NB_ENTRIES && this->entry[id + 1].L &&
+        this->entry[id + 1].A == PMP_MODE_TOR))
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Ignoring write to locked address (id: %d)\n", id);
+        return;
+    }
+
+    this->entry_addr[id] = addr & PMP_ADDR_MASK;
+
+    this->region_update(id);
+    if (id + 1 < CONFIG_GVSOC_ISS_PMP_NB_ENTRIES)
+    {
+        this->region_update(id + 1);
+    }
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Setting address (id: %d, addr: 0x%lx)\n",
+        id, (uint64_t)this->entry_addr[id] << 2);
+}
+
+void Pmp::region_update(int id)
+{
+    uint64_t addr = this->entry_addr[id];
+
+    // Empty region by default
+    this->region_first[id] = 1;
+    this->region_last[id] = 0;
+
+    switch (this->entry[id].A)
+    {
+        case PMP_MODE_TOR:
+        {
+            if (addr != 0)
+            {
+                this->region_first[id] = id == 0 ? 0 : (uint64_t)this->entry_addr[id - 1] << 2;
+                this->region_last[id] = (addr << 2) - 1;
+            }
+            break;
+        }
+
+        case PMP_MODE_NA4:
+        {
+            this->region_first[id] = addr << 2;
+            this->region_last[id] = (addr << 2) + 3;
+            break;
+        }
+
+        case PMP_MODE_NAPOT:
+        {
+            // The size is given by the number of trailing ones, an address with n trailing
+            // ones gives a region of 2^(n+3) bytes
+            int size_bits = __builtin_ctzll(~addr) + 3;
+            if (size_bits >= 64)
+            {
+                this->region_first[id] = 0;
+                this->region_last[id] = -1;
+            }
+            else
+            {
+                uint64_t size = 1ULL << size_bits;
+                this->region_first[id] = (addr << 2) & ~(size - 1);
+                this->region_last[id] = this->region_first[id] + size - 1;
+            }
+            break;
+        }
+    }
+}
+
+static inline bool pmp_entry_allows(PmpEntry *entry, int access, int mode)
+{
+    // Machine mode is only restricted by locked entries
+    return (mode == PRIV_M && !entry->L) || (entry->value & access) != 0;
+}
+
+bool Pmp::page_allowed(iss_addr_t page, int access, int mode)
+{
+    uint64_t first = page;
+    uint64_t last = page + (1 << PMP_PGSHIFT) - 1;
+
+    for (int i=0; i<CONFIG_GVSOC_ISS_PMP_NB_ENTRIES; i++)
+    {
+        if (this->region_first[i] > this->region_last[i] ||
+            this->region_last[i] < first || this->region_first[i] > last)
+        {
+            continue;
+        }
+
+        // The first entry overlapping the page decides for all accesses inside the page only if
+        // it covers it entirely. Otherwise, accesses must be checked one by one.
+        return this->region_first[i] <= first && this->region_last[i] >= last &&
+            pmp_entry_allows(&this->entry[i], access, mode);
+    }
+
+    return mode == PRIV_M;
+}
+
+bool Pmp::access_allowed(iss_addr_t addr, int size, int access, int mode)
+{
+    uint64_t first = addr;
+    uint64_t last = addr + size - 1;
+
+    for (int i=0; i<CONFIG_GVSOC_ISS_PMP_NB_ENTRIES; i++)
+    {
+        if (this->region_first[i] > this->region_last[i] ||
+            this->region_last[i] < first || this->region_first[i] > last)
+        {
+            continue;
+        }
+
+        // The lowest entry matching any byte of the access decides, and the access fails if
+        // it does not match all the bytes
+        return this->region_first[i] <= first && this->region_last[i] >= last &&
+            pmp_entry_allows(&this->entry[i], access, mode);
+    }
+
+    // Supervisor and user accesses fail if no entry matches
+    return mode == PRIV_M;
+}
+
+int Pmp::access_mode_get(int access)
+{
+    int mode = this->iss.core.mode_get();
+    if (access != PMP_ACCESS_X && this->iss.csr.mstatus.mprv)
+    {
+        mode = this->iss.csr.mstatus.mpp;
+    }
+    return mode;
+}
+
+bool Pmp::page_check(iss_addr_t addr, int access, iss_addr_t *cache_tag)
+{
+    iss_addr_t tag = addr >> PMP_PGSHIFT;
+
+    if (this->page_allowed(tag << PMP_PGSHIFT, access, this->access_mode_get(access)))
+    {
+        cache_tag[tag & PMP_CACHE_ENTRIES_MASK] = tag;
+        return true;
+    }
+
     return false;
 }
 
-void Pmp::entry_cfg_set(int id, uint8_t config)
+bool Pmp::check_miss(iss_addr_t addr, int size, int access, iss_addr_t *cache_tag)
 {
-    if (id < CONFIG_GVSOC_ISS_PMP_NB_ENTRIES)
+    int mode = this->access_mode_get(access);
+
+    if (this->access_allowed(addr, size, access, mode))
     {
-        this->entry[id].value = config & 0x9F;
+        // Cache the page if it is fully allowed so that the next accesses to it are fast
+        this->page_check(addr, access, cache_tag);
+        return false;
+    }
 
-        PmpEntry *entry = &this->entry[id];
-        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Setting entry (id: %d, R: %d, W: %d, X: %d, mode: %s)\n",
-            id, entry->R, entry->W, entry->X, entry->get_mode_name().c_str());
+    int cause;
+    if (access == PMP_ACCESS_X)
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Illegal fetch access (pc: 0x%lx, addr: 0x%lx)\n",
+            this->iss.exec.current_insn, addr);
+        cause = ISS_EXCEPT_INSN_FAULT;
     }
+    else if (access == PMP_ACCESS_R)
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Illegal load access (pc: 0x%lx, addr: 0x%lx, size: 0x%x)\n",
+            this->iss.exec.current_insn, addr, size);
+        cause = ISS_EXCEPT_LOAD_FAULT;
+    }
+    else
+    {
+        this->trace.msg(vp::Trace::LEVEL_DEBUG, "Illegal store access (pc: 0x%lx, addr: 0x%lx, size: 0x%x)\n",
+            this->iss.exec.current_insn, addr, size);
+        cause = ISS_EXCEPT_STORE_FAULT;
+    }
+
+    this->iss.exception.raise(this->iss.exec.current_insn, cause);
+
+    return true;
 }
 
 
@@ -26,6 +26,24 @@
 Timing::Timing(Iss &iss)
     : iss(iss)
 {
+    for (int i = 0; i < 32; i++)
+    {
+        this->pccr_pending[i] = 0;
+    }
+}
+
+void Timing::pccr_sync()
+{
+    bool active = this->iss.csr.pcmr & CSR_PCMR_ACTIVE;
+
+    for (int i = 0; i < 32; i++)
+    {
+        if (active && (this->iss.csr.pcer & (1 << i)))
+        {
+            this->iss.csr.pccr[i] += this->pccr_pending[i];
+        }
+        this->pccr_pending[i] = 0;
+    }
 }
 
 void Timing::build()
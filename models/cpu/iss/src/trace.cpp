@@ -20,6 +20,7 @@
  */
 
 #include "cpu/iss/include/iss.hpp"
+#include "cpu/iss/include/debug_info.hpp"
 #include <string.h>
 #include <algorithm>
 #include <vector>
@@ -34,11 +35,22 @@ void Trace::build()
 {
     this->iss.top.traces.new_trace("insn", &this->insn_trace, vp::DEBUG);
     this->insn_trace.register_callback(std::bind(&Trace::insn_trace_callback, this));
-    iss_trace_init(&this->iss);
 
+    // Debug information is read directly from the binaries, the debug binaries are only used
+    // for storing the cache
+    std::vector<js::Config *> binaries;
+    js::Config *binaries_config = this->iss.top.get_js_config()->get("**/binaries");
+    if (binaries_config)
+    {
+        binaries = binaries_config->get_elems();
+    }
+
+    int index = 0;
     for (auto x : this->iss.top.get_js_config()->get("**/debug_binaries")->get_elems())
     {
-        iss_register_debug_info(&this->iss, x->get_str().c_str());
+        std::string binary = index < (int)binaries.size() ? binaries[index]->get_str() : "";
+        iss_register_debug_info(&this->iss, x->get_str().c_str(), binary.c_str());
+        index++;
     }
 
 }
@@ -51,95 +63,31 @@ void Trace::reset(bool active)
     }
 }
 
-#define PC_INFO_ARRAY_SIZE (64 * 1024)
-
 #define MAX_DEBUG_INFO_WIDTH 32
 
-class iss_pc_info
-{
-public:
-    unsigned int base;
-    char *func;
-    char *inline_func;
-    char *file;
-    int line;
-    iss_pc_info *next;
-};
-
-static bool pc_infos_is_init = false;
-static iss_pc_info *pc_infos[PC_INFO_ARRAY_SIZE];
 static std::vector<std::string> binaries;
+static std::vector<DebugInfo *> debug_infos;
 
-static void add_pc_info(unsigned int base, char *func, char *inline_func, char *file, int line)
-{
-    iss_pc_info *pc_info = new iss_pc_info();
-
-    int index = base & (PC_INFO_ARRAY_SIZE - 1);
-    pc_info->next = pc_infos[index];
-    pc_infos[index] = pc_info;
-
-    pc_info->base = base;
-    pc_info->func = strdup(func);
-    pc_info->inline_func = strdup(inline_func);
-    pc_info->file = strdup(file);
-    pc_info->line = line;
-}
-
-static iss_pc_info *get_pc_info(unsigned int base)
+int iss_trace_pc_info(iss_addr_t addr, const char **func, const char **inline_func, const char **file, int *line)
 {
-    int index = base & (PC_INFO_ARRAY_SIZE - 1);
-
-    iss_pc_info *pc_info = pc_infos[index];
-
-    while (pc_info && pc_info->base != base)
+    for (DebugInfo *debug_info: debug_infos)
     {
-        pc_info = pc_info->next;
+        if (debug_info->lookup(addr, func, inline_func, file, line) == 0)
+            return 0;
     }
 
-    return pc_info;
-}
-
-int iss_trace_pc_info(iss_addr_t addr, const char **func, const char **inline_func, const char **file, int *line)
-{
-    iss_pc_info *info = get_pc_info(addr);
-    if (info == NULL)
-        return -1;
-
-    *func = info->func;
-    *inline_func = info->inline_func;
-    *file = info->file;
-    *line = info->line;
-
-    return 0;
+    return -1;
 }
 
-void iss_register_debug_info(Iss *iss, const char *binary)
+void iss_register_debug_info(Iss *iss, const char *path, const char *binary)
 {
-    if (std::find(binaries.begin(), binaries.end(), std::string(binary)) != binaries.end())
+    if (std::find(binaries.begin(), binaries.end(), std::string(path)) != binaries.end())
         return;
 
-    binaries.push_back(std::string(binary));
+    binaries.push_back(std::string(path));
 
-    FILE *file = fopen(binary, "r");
-    if (file != NULL)
-    {
-        char *line = NULL;
-        size_t len = 0;
-        ssize_t read;
-        while ((read = getline(&line, &len, file)) != -1)
-        {
-            char *token = strtok(line, " ");
-            char *tokens[5];
-            int index = 0;
-            while (token)
-            {
-                tokens[index++] = token;
-                token = strtok(NULL, " ");
-            }
-            if (index == 5)
-                add_pc_info(strtol(tokens[0], NULL, 16), tokens[1], tokens[2], tokens[3], atoi(tokens[4]));
-        }
-    }
+    // The information is only loaded during the first lookup
+    debug_infos.push_back(new DebugInfo(path, binary));
 }
 
 static inline char iss_trace_get_mode(int mode)
@@ -369,18 +317,11 @@ static char *iss_trace_dump_arg(Iss *iss, iss_insn_t *insn, char *buff, iss_insn
 
 static char *trace_dump_debug(Iss *iss, iss_insn_t *insn, iss_reg_t pc, char *buff)
 {
-    char *name = (char *)"-";
-    char *file = (char *)"-";
-    uint32_t line = 0;
-    char *inline_func = (char *)"-";
-    iss_pc_info *pc_info = get_pc_info(pc);
-    if (pc_info)
-    {
-        name = pc_info->func;
-        file = pc_info->file;
-        line = pc_info->line;
-        inline_func = pc_info->inline_func;
-    }
+    const char *name = "-";
+    const char *file = "-";
+    int line = 0;
+    const char *inline_func = "-";
+    iss_trace_pc_info(pc, &name, &inline_func, &file, &line);
 
     int line_len = sprintf(buff, ":%d", line);
     if (line_len > 5)
@@ -608,15 +549,6 @@ iss_reg_t iss_exec_insn_with_trace(Iss *iss, iss_insn_t *insn, iss_reg_t pc)
     return next_insn;
 }
 
-void iss_trace_init(Iss *iss)
-{
-    if (!pc_infos_is_init)
-    {
-        pc_infos_is_init = true;
-        memset(pc_infos, 0, sizeof(pc_infos));
-    }
-}
-
 void Trace::dump_debug_traces()
 {
     const char *func, *inline_func, *file;
@@ -26,8 +26,10 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <vp/itf/wire.hpp>
+#include <algorithm>
 
 #define PLIC_PRIO_BITS     4
+#define PLIC_NB_PRIOS     (1 << PLIC_PRIO_BITS)
 #define PLIC_SIZE         0x01000000
 #define PLIC_MAX_CONTEXTS 15872
 #define PLIC_MAX_DEVICES 1024
@@ -108,6 +110,18 @@ struct plic_context_t {
         uint32_t pending[PLIC_MAX_DEVICES/32];
         uint8_t pending_priority[PLIC_MAX_DEVICES];
         uint32_t claimed[PLIC_MAX_DEVICES/32];
+
+        /*
+         * Sources which are pending and not claimed, sorted by pending priority, so that the
+         * best one is found with a few find-first-set instead of scanning all sources.
+         * ready_words has one bit per non-empty word of each priority bitmap, and ready_prios
+         * one bit per non-empty priority.
+         */
+        uint32_t ready[PLIC_NB_PRIOS][PLIC_MAX_DEVICES/32];
+        uint32_t ready_words[PLIC_NB_PRIOS];
+        uint32_t ready_prios;
+        // Last level sent on the interrupt line
+        bool irq_active;
 };
 
 
@@ -138,8 +152,13 @@ private:
     uint32_t max_prio;
     uint8_t priority[PLIC_MAX_DEVICES];
     uint32_t level[PLIC_MAX_DEVICES/32];
+    // Per source, the contexts where it is enabled, in increasing order
+    std::vector<std::vector<uint32_t>> source_contexts;
+    void context_ready_remove(plic_context_t *c, uint32_t id);
+    void context_ready_add(plic_context_t *c, uint32_t id);
+    void source_context_set(uint32_t id, uint32_t context, bool enabled);
     uint32_t context_best_pending(const plic_context_t *c);
-    void context_update(const plic_context_t *context);
+    void context_update(plic_context_t *context);
     uint32_t context_claim(plic_context_t *c);
     bool priority_read(reg_t offset, uint32_t *val);
     bool priority_write(reg_t offset, uint32_t val);
@@ -176,22 +195,23 @@ void Plic::irq_sync(vp::Block *__this, bool active, int port)
     * there is no notion of edge-triggered interrupts. To
     * handle this we auto-clear edge-triggered interrupts
     * when PLIC context CLAIM register is read.
+    * Only the first context where the source is enabled is updated.
     */
-    for (size_t i = 0; i < _this->contexts.size(); i++) {
-        plic_context_t* c = &_this->contexts[i];
-
-        if (c->enable[id_word] & id_mask) {
-            if (active) {
-                c->pending[id_word] |= id_mask;
-                c->pending_priority[id] = id_prio;
-            } else {
-                c->pending[id_word] &= ~id_mask;
-                c->pending_priority[id] = 0;
-                c->claimed[id_word] &= ~id_mask;
-            }
-            _this->context_update(c);
-            break;
+    std::vector<uint32_t> &source_contexts = _this->source_contexts[id];
+    if (source_contexts.size() != 0) {
+        plic_context_t* c = &_this->contexts[source_contexts[0]];
+
+        _this->context_ready_remove(c, id);
+        if (active) {
+            c->pending[id_word] |= id_mask;
+            c->pending_priority[id] = id_prio;
+        } else {
+            c->pending[id_word] &= ~id_mask;
+            c->pending_priority[id] = 0;
+            c->claimed[id_word] &= ~id_mask;
         }
+        _this->context_ready_add(c, id);
+        _this->context_update(c);
     }
 }
 
@@ -217,39 +237,82 @@ vp::IoReqStatus Plic::req(vp::Block *__this, vp::IoReq *req)
 
 
 
-uint32_t Plic::context_best_pending(const plic_context_t *c)
+// Must be called before modifying the pending, claimed or pending priority state of a source
+void Plic::context_ready_remove(plic_context_t *c, uint32_t id)
 {
-  uint8_t best_id_prio = 0;
-  uint32_t best_id = 0;
+  uint32_t id_word = id / 32;
+  uint32_t id_mask = 1 << (id % 32);
+  uint8_t prio = c->pending_priority[id];
 
-  for (uint32_t i = 0; i < num_ids_word; i++) {
-    if (!c->pending[i]) {
-      continue;
+  if (!(c->ready[prio][id_word] & id_mask)) {
+    return;
+  }
+
+  c->ready[prio][id_word] &= ~id_mask;
+  if (c->ready[prio][id_word] == 0) {
+    c->ready_words[prio] &= ~(1 << id_word);
+    if (c->ready_words[prio] == 0) {
+      c->ready_prios &= ~(1 << prio);
     }
+  }
+}
 
-    for (uint32_t j = 0; j < 32; j++) {
-      uint32_t id = i * 32 + j;
-      if ((num_ids <= id) ||
-          !(c->pending[i] & (1 << j)) ||
-          (c->claimed[i] & (1 << j))) {
-        continue;
-      }
+// Must be called after modifying the pending, claimed or pending priority state of a source
+void Plic::context_ready_add(plic_context_t *c, uint32_t id)
+{
+  uint32_t id_word = id / 32;
+  uint32_t id_mask = 1 << (id % 32);
+  uint8_t prio = c->pending_priority[id];
+
+  if (id >= num_ids ||
+      !(c->pending[id_word] & id_mask) ||
+      (c->claimed[id_word] & id_mask)) {
+    return;
+  }
 
-      if (!best_id ||
-          (best_id_prio < c->pending_priority[id])) {
-        best_id = id;
-        best_id_prio = c->pending_priority[id];
-      }
+  c->ready[prio][id_word] |= id_mask;
+  c->ready_words[prio] |= 1 << id_word;
+  c->ready_prios |= 1 << prio;
+}
+
+void Plic::source_context_set(uint32_t id, uint32_t context, bool enabled)
+{
+  std::vector<uint32_t> &contexts = this->source_contexts[id];
+  auto it = std::lower_bound(contexts.begin(), contexts.end(), context);
+
+  if (enabled) {
+    if (it == contexts.end() || *it != context) {
+      contexts.insert(it, context);
     }
+  } else if (it != contexts.end() && *it == context) {
+    contexts.erase(it);
   }
+}
 
-  return best_id;
+uint32_t Plic::context_best_pending(const plic_context_t *c)
+{
+  if (c->ready_prios == 0) {
+    return 0;
+  }
+
+  // Highest priority first, and lowest ID among sources with the same priority
+  uint32_t prio = 31 - __builtin_clz(c->ready_prios);
+  uint32_t id_word = __builtin_ctz(c->ready_words[prio]);
+
+  return id_word * 32 + __builtin_ctz(c->ready[prio][id_word]);
 }
 
-void Plic::context_update(const plic_context_t *c)
+void Plic::context_update(plic_context_t *c)
 {
     uint32_t best_id = context_best_pending(c);
     bool active = best_id != 0;
+
+    if (active == c->irq_active)
+    {
+        return;
+    }
+
+    c->irq_active = active;
     if (c->mmode)
     {
         this->m_irq_itf[c->proc_id].sync(active);
@@ -267,6 +330,7 @@ uint32_t Plic::context_claim(plic_context_t *c)
   uint32_t best_id_mask = (1 << (best_id % 32));
 
   if (best_id) {
+    context_ready_remove(c, best_id);
     c->claimed[best_id_word] |= best_id_mask;
   }
 
@@ -332,6 +396,10 @@ bool Plic::context_enable_write(plic_context_t *c,
     if (!(xor_val & id_mask)) {
       continue;
     }
+    if (id < num_ids) {
+      source_context_set(id, c->num, new_val & id_mask);
+    }
+    context_ready_remove(c, id);
     if ((new_val & id_mask) &&
         (level[id_word] & id_mask)) {
       c->pending[id_word] |= id_mask;
@@ -341,6 +409,7 @@ bool Plic::context_enable_write(plic_context_t *c,
       c->pending_priority[id] = 0;
       c->claimed[id_word] &= ~id_mask;
     }
+    context_ready_add(c, id);
   }
 
   context_update(c);
@@ -380,7 +449,9 @@ bool Plic::context_write(plic_context_t *c,
       uint32_t id_mask = 1 << (val % 32);
       if ((val < num_ids) &&
           (c->enable[id_word] & id_mask)) {
+        context_ready_remove(c, val);
         c->claimed[id_word] &= ~id_mask;
+        context_ready_add(c, val);
         update = true;
       }
       break;
@@ -513,6 +584,7 @@ Plic::Plic(vp::ComponentConf &config)
     max_prio = (1UL << PLIC_PRIO_BITS) - 1;
     memset(priority, 0, sizeof(priority));
     memset(level, 0, sizeof(level));
+    this->source_contexts.resize(num_ids);
 
     for (size_t i = 0; i < contexts.size(); i++) {
         plic_context_t* c = &contexts[i];
@@ -527,6 +599,10 @@ Plic::Plic(vp::ComponentConf &config)
         memset(&c->pending, 0, sizeof(c->pending));
         memset(&c->pending_priority, 0, sizeof(c->pending_priority));
         memset(&c->claimed, 0, sizeof(c->claimed));
+        memset(&c->ready, 0, sizeof(c->ready));
+        memset(&c->ready_words, 0, sizeof(c->ready_words));
+        c->ready_prios = 0;
+        c->irq_active = false;
     }
 }
 
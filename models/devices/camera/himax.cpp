@@ -506,6 +506,10 @@ void Himax::reset(bool active)
         this->href = !this->hsync_polarity;
         this->data = 0;
         this->pixel_bytes = 0;
+        this->bytesel = 0;
+        this->colptr = 0;
+        this->lineptr = 0;
+        this->framesel = 0;
     }
     if (!active && this->stream)
     {
@@ -27,14 +27,9 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <sys/mman.h>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-
 #include <vp/itf/hyper.hpp>
 #include <vp/itf/wire.hpp>
+#include <flash_storage.hpp>
 
 // Flash sector size
 #define MX25_SECTOR_SIZE (1 << 12)
@@ -118,18 +113,6 @@ private:
      */
     static void cs_sync_stub(vp::Block *__this, int cs, int value);
 
-    /**
-     * @brief Preload the specified file into the flash
-     *
-     * The flash array can be preloaded with the content of a file.
-     * It can also be kept synced with it, so that the flash array can be accessed from the
-     * workstation at the end of the simulation, or to relaunch a simulation with the flash content
-     * at the end of the simulation.
-     *
-     * @param path   Path to the file
-     * @param writeback True if the file should be kept synced with the flash array so that.
-     */
-    int preload_file(char *path, bool writeback);
 
     /**
      * @brief Send the next output data
@@ -253,8 +236,8 @@ private:
     vp::HyperSlave in_itf;
     // Size of the flash, retrieved from JSON component configuration.
     int size;
-    // Flash array
-    uint8_t *data;
+    // Flash array, mapped from the preload file if any
+    FlashStorage *storage;
     // Flash state
     mx25_state_e octospi_state;
     // Current command being process
@@ -343,7 +326,7 @@ void Mx25::erase_sector(unsigned int addr)
     }
 
     // State of the array bytes after erase is 1 for each bit.
-    memset(&this->data[addr], 0xff, MX25_SECTOR_SIZE);
+    this->storage->erase_sector(addr);
 }
 
 
@@ -351,10 +334,8 @@ void Mx25::erase_sector(unsigned int addr)
 void Mx25::erase_chip()
 {
     this->trace.msg(vp::Trace::LEVEL_INFO, "Erasing chip\n");
-    for (unsigned int addr = 0; addr < this->size; addr += MX25_SECTOR_SIZE)
-    {
-        this->erase_sector(addr);
-    }
+    // Erase the whole array at once rather than sector by sector
+    this->storage->erase_chip();
 }
 
 
@@ -371,7 +352,7 @@ uint32_t Mx25::handle_array_access(int address, int is_write, uint8_t data)
     if (!is_write)
     {
         uint8_t data;
-        data = this->data[address];
+        data = this->storage->read(address);
         this->trace.msg(vp::Trace::LEVEL_TRACE,
             "Sending data byte (address: 0x%x, value: 0x%x)\n", address, data);
         return data;
@@ -383,16 +364,16 @@ uint32_t Mx25::handle_array_access(int address, int is_write, uint8_t data)
 
         // The program operation can only switch bits from 1 to 0.
         // Check if some bits can not be set to zero.
-        uint8_t new_value = this->data[address] & data;
+        uint8_t new_value = this->storage->read(address) & data;
 
         if (new_value != data)
         {
             this->trace.force_warning(
                 "Failed to program specified location (addr: 0x%x, flash_val: 0x%2.2x, "
-                "program_val: 0x%2.2x)\n", address, this->data[address], data);
+                "program_val: 0x%2.2x)\n", address, this->storage->read(address), data);
         }
 
-        this->data[address] &= data;
+        this->storage->write(address, new_value);
         this->program_ongoing = true;
         this->write_enable = false;
         this->program_size++;
@@ -885,73 +866,6 @@ void Mx25::cs_sync(int cs, int value)
 
 
 
-int Mx25::preload_file(char *path, bool writeback)
-{
-    this->trace.msg(vp::Trace::LEVEL_INFO,
-        "Preloading memory with stimuli file (path: %s)\n", path);
-
-    if (writeback)
-    {
-        // Writeback mode where the file is kept synced with the flash array so that it is still
-        // available at the end of the simulation.
-
-        // Create a read/write file and map it in the process to directly access the file
-        // from the flash array
-        int fd = open(path, O_RDWR | O_CREAT, 0600);
-        if (fd < 0)
-        {
-            this->trace.force_warning("Unable to open writeback file (path: %s, error: %s)\n",
-                path, strerror(errno));
-            return -1;
-        }
-
-        if (ftruncate(fd, this->size) < 0)
-        {
-            this->trace.force_warning("Unable to truncate writeback file (path: %s, error: %s)\n",
-                path, strerror(errno));
-            close(fd);
-            return -1;
-        }
-        this->data = (uint8_t *)mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-        if (!this->data)
-        {
-            this->trace.force_warning("Unable to mmap writeback file (path: %s, error: %s)\n",
-                path, strerror(errno));
-            close(fd);
-            return -1;
-        }
-
-        // fd is even not useful anymore and can be closed.
-        // Data are automatically write back to the file
-        // at random time during execution (depending of the kernel cache behavior)
-        // and, anyway, at the termination of the application.
-        close(fd);
-    }
-    else
-    {
-        // Classic mode where the file is just used as an input file for the flash array.
-        FILE *file = fopen(path, "r");
-        if (file == NULL)
-        {
-            this->trace.force_warning("Unable to open preload file (path: %s, error: %s)\n",
-                path, strerror(errno));
-            return -1;
-        }
-
-        if (fread(this->data, 1, this->size, file) == 0)
-        {
-            this->trace.force_warning
-                ("Unable to read from preload file file (path: %s, error: %s)\n",
-                path, strerror(errno));
-            return -1;
-        }
-    }
-
-    return 0;
-}
-
-
-
 void Mx25::sync_cycle_stub(vp::Block *__this, int data)
 {
     // Stub for real method, just forward the call
@@ -1016,23 +930,16 @@ Mx25::Mx25(vp::ComponentConf &config)
 
     this->trace.msg(vp::Trace::LEVEL_INFO, "Building flash (size: 0x%x)\n", this->size);
 
-    // If there is no preload file or if the preload file is a classi input file,
-    // Allocate an array for the flash and fill it with clean state which is 1 everywhere so that
-    //. the whole flash can be programmed without being erased.
-    if (!preload_file_conf || !writeback)
+    // The flash array is mapped from the preload file if any, either privately so that it is
+    // only used as an input, or in shared mode in writeback mode so that the file is kept synced
+    // with the flash array and can be reused at the end of the simulation.
+    // Without preload file, the array starts in erased state so that the whole flash can be
+    // programmed without being erased.
+    this->storage = new FlashStorage(&this->trace, this->size, MX25_SECTOR_SIZE);
+    std::string preload_path = preload_file_conf ? preload_file_conf->get_str() : "";
+    if (this->storage->init(preload_file_conf ? preload_path.c_str() : NULL, writeback))
     {
-        this->data = new uint8_t[this->size];
-        memset(this->data, 0xff, this->size);
-    }
-
-    // The preload file can be either input file, or memory-mapped file to keep flash content
-    // on workstation
-    if (preload_file_conf)
-    {
-        if (this->preload_file((char *)preload_file_conf->get_str().c_str(), writeback))
-        {
-            this->trace.fatal("Unable to preload file\n");
-        }
+        this->trace.fatal("Unable to preload file\n");
     }
 
 }
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "flash_storage.hpp"
+
+
+FlashStorage::FlashStorage(vp::Trace *trace, int64_t size, int64_t sector_size, uint8_t erase_value)
+    : trace(trace), size(size), sector_size(sector_size), erase_value(erase_value), data(NULL),
+    shared(false)
+{
+    this->sector_shift = __builtin_ctzll(sector_size);
+    int64_t nb_sectors = (size + sector_size - 1) >> this->sector_shift;
+    this->dirty.resize((nb_sectors + 63) / 64, 0);
+}
+
+
+
+FlashStorage::~FlashStorage()
+{
+    this->unmap();
+}
+
+
+
+void FlashStorage::unmap()
+{
+    if (this->data)
+    {
+        this->flush();
+        munmap(this->data, this->size);
+        this->data = NULL;
+    }
+}
+
+
+
+int FlashStorage::map_anonymous()
+{
+    // Anonymous pages are only allocated by the kernel when they are touched, so that the
+    // mapping itself is immediate whatever the flash size.
+    void *data = mmap(NULL, this->size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (data == MAP_FAILED)
+    {
+        this->trace->force_warning("Unable to allocate flash array (size: 0x%llx, error: %s)\n",
+            this->size, strerror(errno));
+        return -1;
+    }
+
+    this->data = (uint8_t *)data;
+    return 0;
+}
+
+
+
+int FlashStorage::init(const char *path, bool writeback)
+{
+    this->unmap();
+    this->shared = false;
+
+    if (path == NULL)
+    {
+        if (this->map_anonymous())
+        {
+            return -1;
+        }
+        memset(this->data, this->erase_value, this->size);
+        return 0;
+    }
+
+    this->trace->msg(vp::Trace::LEVEL_INFO, "Mapping flash image (path: %s, writeback: %d)\n",
+        path, writeback);
+
+    int fd = open(path, writeback ? O_RDWR | O_CREAT : O_RDONLY, 0600);
+    if (fd < 0)
+    {
+        this->trace->force_warning("Unable to open flash image (path: %s, error: %s)\n",
+            path, strerror(errno));
+        return -1;
+    }
+
+    struct stat stat;
+    if (fstat(fd, &stat) < 0)
+    {
+        this->trace->force_warning("Unable to stat flash image (path: %s, error: %s)\n",
+            path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    int64_t file_size = stat.st_size < this->size ? stat.st_size : this->size;
+
+    if (writeback)
+    {
+        // The file is directly the flash array, modifications are written back by the kernel
+        // during the execution and at the latest when the mapping is released.
+        if (stat.st_size < this->size && ftruncate(fd, this->size) < 0)
+        {
+            this->trace->force_warning("Unable to extend flash image (path: %s, error: %s)\n",
+                path, strerror(errno));
+            close(fd);
+            return -1;
+        }
+
+        void *data = mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            this->trace->force_warning("Unable to map flash image (path: %s, error: %s)\n",
+                path, strerror(errno));
+            close(fd);
+            return -1;
+        }
+
+        this->data = (uint8_t *)data;
+        this->shared = true;
+    }
+    else
+    {
+        // Map the image privately over an anonymous area covering the whole flash, so that
+        // pages are only read from the file when accessed and modifications stay local to
+        // the simulation.
+        if (this->map_anonymous())
+        {
+            close(fd);
+            return -1;
+        }
+
+        if (file_size > 0)
+        {
+            int64_t page_size = sysconf(_SC_PAGESIZE);
+            int64_t map_size = (file_size + page_size - 1) & ~(page_size - 1);
+            if (map_size > this->size)
+            {
+                map_size = file_size;
+            }
+
+            if (mmap(this->data, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+                fd, 0) == MAP_FAILED)
+            {
+                this->trace->force_warning("Unable to map flash image (path: %s, error: %s)\n",
+                    path, strerror(errno));
+                close(fd);
+                return -1;
+            }
+        }
+    }
+
+    close(fd);
+
+    // The part of the flash not covered by the image is in erased state
+    if (file_size < this->size)
+    {
+        memset(&this->data[file_size], this->erase_value, this->size - file_size);
+        if (this->shared)
+        {
+            this->mark_dirty(file_size, this->size - file_size);
+        }
+    }
+
+    return 0;
+}
+
+
+
+int FlashStorage::set_writeback_file(const char *path)
+{
+    this->trace->msg(vp::Trace::LEVEL_INFO, "Writeback flash array to file (path: %s)\n", path);
+
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0)
+    {
+        this->trace->force_warning("Unable to open writeback file (path: %s, error: %s)\n",
+            path, strerror(errno));
+        return -1;
+    }
+
+    if (ftruncate(fd, this->size) < 0)
+    {
+        this->trace->force_warning("Unable to truncate writeback file (path: %s, error: %s)\n",
+            path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    void *data = mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        this->trace->force_warning("Unable to map writeback file (path: %s, error: %s)\n",
+            path, strerror(errno));
+        return -1;
+    }
+
+    memcpy(data, this->data, this->size);
+    this->unmap();
+    this->data = (uint8_t *)data;
+    this->shared = true;
+    this->mark_dirty(0, this->size);
+
+    return 0;
+}
+
+
+
+void FlashStorage::erase(int64_t addr, int64_t size)
+{
+    if (addr + size > this->size)
+    {
+        size = this->size - addr;
+    }
+    if (size <= 0)
+    {
+        return;
+    }
+
+    memset(&this->data[addr], this->erase_value, size);
+    this->mark_dirty(addr, size);
+}
+
+
+
+void FlashStorage::erase_sector(int64_t addr)
+{
+    this->erase(addr & ~(this->sector_size - 1), this->sector_size);
+}
+
+
+
+void FlashStorage::erase_chip()
+{
+    this->erase(0, this->size);
+}
+
+
+
+int64_t FlashStorage::get_nb_dirty_sectors()
+{
+    int64_t result = 0;
+    for (uint64_t word: this->dirty)
+    {
+        result += __builtin_popcountll(word);
+    }
+    return result;
+}
+
+
+
+void FlashStorage::flush()
+{
+    for (size_t i=0; i<this->dirty.size(); i++)
+    {
+        uint64_t word = this->dirty[i];
+        this->dirty[i] = 0;
+
+        if (!this->shared)
+        {
+            continue;
+        }
+
+        // Schedule the write of each contiguous range of modified sectors
+        while (word)
+        {
+            int first = __builtin_ctzll(word);
+            int last = first;
+            while (last < 64 && (word >> last) & 1)
+            {
+                last++;
+            }
+            word = last == 64 ? 0 : word & ~((1ULL << last) - 1);
+
+            int64_t addr = ((int64_t)(i * 64 + first)) << this->sector_shift;
+            int64_t size = ((int64_t)(last - first)) << this->sector_shift;
+            if (addr + size > this->size)
+            {
+                size = this->size - addr;
+            }
+
+            msync(&this->data[addr], size, MS_ASYNC);
+        }
+    }
+}
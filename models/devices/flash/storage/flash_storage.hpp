@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <vp/vp.hpp>
+
+/**
+ * @brief Backing store for flash arrays
+ *
+ * This provides the flash array of flash models as a memory-mapped area.
+ * Without image, the array is an anonymous mapping in erased state.
+ * With an input image, the file is mapped privately so that only the pages which are accessed
+ * are read from the workstation, whatever the size of the flash.
+ * In writeback mode, the file is mapped in shared mode so that program and erase operations
+ * are directly visible in the file and are kept across runs.
+ * Sectors modified by program and erase operations are tracked so that only them are flushed
+ * back to the file.
+ */
+class FlashStorage
+{
+public:
+    /**
+     * @brief Construct a new flash storage
+     *
+     * The array is not available until init is called.
+     *
+     * @param trace       Trace of the flash model, used for reporting errors.
+     * @param size        Size in bytes of the flash array.
+     * @param sector_size Size in bytes of an erase sector. Must be a power of 2.
+     * @param erase_value Value of the bytes of an erased sector.
+     */
+    FlashStorage(vp::Trace *trace, int64_t size, int64_t sector_size, uint8_t erase_value=0xff);
+    ~FlashStorage();
+
+    /**
+     * @brief Map the flash array
+     *
+     * @param path      Path of the image file, or NULL to start with an erased flash.
+     * @param writeback True if the image file should be kept synced with the flash array. The
+     *     file is created if it does not exist and extended with erased sectors if it is smaller
+     *     than the flash.
+     * @return 0 if successful, -1 otherwise.
+     */
+    int init(const char *path, bool writeback);
+
+    /**
+     * @brief Move the flash array to a writeback file
+     *
+     * The current content of the array is copied to the file, which is then kept synced with
+     * the flash array.
+     *
+     * @param path Path of the output file.
+     * @return 0 if successful, -1 otherwise.
+     */
+    int set_writeback_file(const char *path);
+
+    /**
+     * @brief Erase a range of the flash array
+     *
+     * The range is not aligned on sectors, this is up to the caller to do it according to the
+     * flash erase granularity.
+     *
+     * @param addr Address of the first byte to erase.
+     * @param size Number of bytes to erase.
+     */
+    void erase(int64_t addr, int64_t size);
+
+    /**
+     * @brief Erase the sector containing the specified address
+     */
+    void erase_sector(int64_t addr);
+
+    /**
+     * @brief Erase the whole flash array
+     */
+    void erase_chip();
+
+    /**
+     * @brief Flush modified sectors to the image file
+     *
+     * This only does something in writeback mode, as the file is otherwise never modified.
+     */
+    void flush();
+
+    /**
+     * @brief Return the number of sectors modified since the last flush
+     */
+    int64_t get_nb_dirty_sectors();
+
+    inline uint8_t *get_data() { return this->data; }
+    inline int64_t get_size() { return this->size; }
+    inline int64_t get_sector_size() { return this->sector_size; }
+
+    inline uint8_t read(int64_t addr) { return this->data[addr]; }
+    inline void write(int64_t addr, uint8_t value);
+    inline void mark_dirty(int64_t addr, int64_t size);
+
+private:
+    int map_anonymous();
+    void unmap();
+
+    vp::Trace *trace;
+    // Size of the flash array.
+    int64_t size;
+    // Size of an erase sector and its log2.
+    int64_t sector_size;
+    int sector_shift;
+    // Value of erased bytes.
+    uint8_t erase_value;
+    // Flash array.
+    uint8_t *data;
+    // True if the array is a shared mapping of the image file.
+    bool shared;
+    // One bit per sector, set when the sector is modified and cleared when it is flushed.
+    std::vector<uint64_t> dirty;
+};
+
+
+inline void FlashStorage::mark_dirty(int64_t addr, int64_t size)
+{
+    int64_t first = addr >> this->sector_shift;
+    int64_t last = (addr + size - 1) >> this->sector_shift;
+    for (int64_t sector = first; sector <= last; sector++)
+    {
+        this->dirty[sector >> 6] |= 1ULL << (sector & 63);
+    }
+}
+
+
+inline void FlashStorage::write(int64_t addr, uint8_t value)
+{
+    this->data[addr] = value;
+    this->dirty[addr >> (this->sector_shift + 6)] |= 1ULL << ((addr >> this->sector_shift) & 63);
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the flash storage writeback mode.
+ *
+ * It programs and erases a flash array backed by a file, flushes it, and then maps the same
+ * file again to check that the content was kept. It does not need the engine library, the
+ * unused engine code pulled by the headers is removed at link time, and can be built and run
+ * from the repository root with:
+ *
+ *   g++ -O2 -ffunction-sections -Wl,--gc-sections \
+ *       -I engine/include -I models/devices/flash/storage \
+ *       models/devices/flash/storage/flash_storage_check.cpp \
+ *       models/devices/flash/storage/flash_storage.cpp -o flash_storage_check
+ *   ./flash_storage_check
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "flash_storage.hpp"
+
+#define FLASH_SIZE        (1 << 20)
+#define FLASH_SECTOR_SIZE (1 << 12)
+
+
+// The storage only uses the trace to report errors, which are just printed here
+void vp::Trace::force_warning(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+}
+
+
+static int check_byte(FlashStorage *storage, int64_t addr, uint8_t expected)
+{
+    uint8_t value = storage->read(addr);
+    if (value != expected)
+    {
+        fprintf(stderr, "Mismatch (addr: 0x%lx, value: 0x%x, expected: 0x%x)\n",
+            (long)addr, value, expected);
+        return -1;
+    }
+    return 0;
+}
+
+
+static uint8_t pattern(int64_t addr)
+{
+    return (addr * 7 + 3) & 0xfe;
+}
+
+
+int main()
+{
+    char path[] = "/tmp/flash_storage_check_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    int errors = 0;
+
+    // First run, starting from an empty file which must be extended with erased sectors
+    FlashStorage *storage = new FlashStorage(NULL, FLASH_SIZE, FLASH_SECTOR_SIZE);
+    if (storage->init(path, true))
+    {
+        return 1;
+    }
+
+    errors += check_byte(storage, 0, 0xff) != 0;
+    errors += check_byte(storage, FLASH_SIZE - 1, 0xff) != 0;
+
+    for (int64_t addr=0; addr<2*FLASH_SECTOR_SIZE; addr++)
+    {
+        storage->write(addr, pattern(addr));
+    }
+    storage->write(FLASH_SIZE - 1, 0x5a);
+    storage->erase_sector(FLASH_SECTOR_SIZE + 16);
+
+    if (storage->get_nb_dirty_sectors() == 0)
+    {
+        fprintf(stderr, "No dirty sector after program and erase\n");
+        errors++;
+    }
+
+    storage->flush();
+
+    if (storage->get_nb_dirty_sectors() != 0)
+    {
+        fprintf(stderr, "Dirty sectors remaining after flush\n");
+        errors++;
+    }
+
+    delete storage;
+
+    struct stat stat;
+    if (::stat(path, &stat) || stat.st_size != FLASH_SIZE)
+    {
+        fprintf(stderr, "Writeback file has not been extended to the flash size\n");
+        errors++;
+    }
+
+    // Second run, the content of the first one must be found again
+    storage = new FlashStorage(NULL, FLASH_SIZE, FLASH_SECTOR_SIZE);
+    if (storage->init(path, true))
+    {
+        return 1;
+    }
+
+    for (int64_t addr=0; addr<FLASH_SECTOR_SIZE; addr++)
+    {
+        errors += check_byte(storage, addr, pattern(addr)) != 0;
+    }
+    for (int64_t addr=FLASH_SECTOR_SIZE; addr<2*FLASH_SECTOR_SIZE; addr++)
+    {
+        errors += check_byte(storage, addr, 0xff) != 0;
+    }
+    errors += check_byte(storage, FLASH_SIZE - 1, 0x5a) != 0;
+
+    delete storage;
+
+    unlink(path);
+
+    printf("%s (errors: %d)\n", errors ? "FAILED" : "PASSED", errors);
+
+    return errors != 0;
+}
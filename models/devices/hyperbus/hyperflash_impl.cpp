@@ -23,14 +23,9 @@
 #include <stdio.h>
 #include <string.h>
 
-#include <sys/mman.h>
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-
 #include <vp/itf/hyper.hpp>
 #include <vp/itf/wire.hpp>
+#include <flash_storage.hpp>
 
 #define REGS_AREA_SIZE 1024
 
@@ -73,10 +68,8 @@ public:
   Hyperflash(vp::ComponentConf &conf);
 
   void handle_access(int reg_access, int address, int read, uint8_t data);
-  int preload_file(char *path);
   void erase_sector(unsigned int addr);
   void erase_chip();
-  int setup_writeback_file(const char *path);
 
   static void sync_cycle(vp::Block *_this, int data);
   static void cs_sync(vp::Block *__this, int cs, int value);
@@ -88,8 +81,7 @@ protected:
   vp::HyperSlave   in_itf;
 
   int size;
-  uint8_t *data;
-  bool data_is_mmapped;
+  FlashStorage *storage;
   uint8_t *reg_data;
 
   hyperflash_state_e state;
@@ -137,7 +129,7 @@ void Hyperflash::erase_sector(unsigned int addr)
     return;
   }
 
-  memset(&this->data[addr], 0xff, FLASH_SECTOR_SIZE);
+  this->storage->erase_sector(addr);
 }
 
 
@@ -145,10 +137,7 @@ void Hyperflash::erase_sector(unsigned int addr)
 void Hyperflash::erase_chip()
 {
   this->trace.msg(vp::Trace::LEVEL_INFO, "Erasing chip\n");
-  for (unsigned int addr=0; addr<addr + this->size; addr+= FLASH_SECTOR_SIZE)
-  {
-    this->erase_sector(addr);
-  }
+  this->storage->erase_chip();
 }
 
 
@@ -175,7 +164,7 @@ void Hyperflash::handle_access(int reg_access, int address, int read, uint8_t da
       }
       else
       {
-        data = this->data[address];
+        data = this->storage->read(address);
         this->trace.msg(vp::Trace::LEVEL_TRACE, "Sending data byte (address: 0x%x, value: 0x%x)\n", address, data);
       }
       this->in_itf.sync_cycle(data);
@@ -195,14 +184,14 @@ void Hyperflash::handle_access(int reg_access, int address, int read, uint8_t da
           {
             this->trace.msg(vp::Trace::LEVEL_TRACE, "[Write Buffer Programming] Writing to flash (address: 0x%x, value: 0x%x)\n", address, data);
 
-            uint8_t new_value = this->data[address] & data;
+            uint8_t new_value = this->storage->read(address) & data;
 
             if (new_value != data)
             {
-              this->trace.force_warning("Failed to program specified location (addr: 0x%x, flash_val: 0x%2.2x, program_val: 0x%2.2x)\n", address, this->data[address], data);
+              this->trace.force_warning("Failed to program specified location (addr: 0x%x, flash_val: 0x%2.2x, program_val: 0x%2.2x)\n", address, this->storage->read(address), data);
             }
 
-            this->data[address] &= new_value;
+            this->storage->write(address, new_value);
 
             if(pending_bytes)
             {
@@ -219,14 +208,14 @@ void Hyperflash::handle_access(int reg_access, int address, int read, uint8_t da
         {
           this->trace.msg(vp::Trace::LEVEL_TRACE, "[Word Programming] Writing to flash (address: 0x%x, value: 0x%x)\n", address, data);
 
-          uint8_t new_value = this->data[address] & data;
+          uint8_t new_value = this->storage->read(address) & data;
 
           if (new_value != data)
           {
-            this->trace.force_warning("Failed to program specified location (addr: 0x%x, flash_val: 0x%2.2x, program_val: 0x%2.2x)\n", address, this->data[address], data);
+            this->trace.force_warning("Failed to program specified location (addr: 0x%x, flash_val: 0x%2.2x, program_val: 0x%2.2x)\n", address, this->storage->read(address), data);
           }
 
-          this->data[address] &= data;
+          this->storage->write(address, new_value);
         }
       }
       else
@@ -329,96 +318,6 @@ void Hyperflash::handle_access(int reg_access, int address, int read, uint8_t da
   }
 }
 
-int Hyperflash::preload_file(char *path)
-{
-  this->trace.msg(vp::Trace::LEVEL_INFO, "Preloading memory with stimuli file (path: %s)\n", path);
-
-  if (this->get_js_config()->get_child_bool("writeback"))
-  {
-    int fd = open(path, O_RDWR | O_CREAT, 0600);
-    if (fd < 0) {
-      printf("Unable to open writeback file (path: %s, error: %s)\n", path, strerror(errno));
-      return 0;
-    }
-
-    if (ftruncate(fd, this->size) < 0) {
-      printf("Unable to truncate writeback file (path: %s, error: %s)\n", path, strerror(errno));
-      close(fd);
-      return -1;
-    }
-    this->data = (uint8_t *) mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED , fd, 0);
-    if (!this->data) {
-      printf("Unable to mmap writeback file (path: %s, error: %s)\n", path, strerror(errno));
-      close(fd);
-      return -1;
-    }
-
-    /*
-    * fd is even not useful anymore and can be closed.
-    * Data are automatically write back to the file
-    * at random time during execution (depending of the kernel cache behavior)
-    * and, anyway, at the termination of the application.
-    */
-    close(fd);
-  }
-  else
-  {
-    FILE *file = fopen(path, "r");
-    if (file == NULL) {
-      printf("Unable to open stimulus file (path: %s, error: %s)\n", path, strerror(errno));
-      return -1;
-    }
-
-    if (fread(this->data, 1, this->size, file) == 0)
-      return -1;
-  }
-
-  return 0;
-}
-
-/*
- * Bback the data memory to a mmap file to provide access to the hyperflash content
- * at the end of the execution.
- */
-int Hyperflash::setup_writeback_file(const char *path)
-{
-  this->trace.msg("writeback memory to an output file (path: %s)\n", path);
-  int fd = open(path, O_RDWR | O_CREAT, 0600);
-  if (fd < 0) {
-	  printf("Unable to open writeback file (path: %s, error: %s)\n", path, strerror(errno));
-	  return 0;
-  }
-
-  if (ftruncate(fd, this->size) < 0) {
-	  printf("Unable to truncate writeback file (path: %s, error: %s)\n", path, strerror(errno));
-	  close(fd);
-	  return -1;
-  }
-  uint8_t *mmapped_data = (uint8_t *) mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED , fd, 0);
-  if (!mmapped_data) {
-	  printf("Unable to mmap writeback file (path: %s, error: %s)\n", path, strerror(errno));
-	  close(fd);
-	  return -1;
-  }
-
-  /* copy the current data content into the mmap area and replace data pointer with the mmap pointer */
-  memcpy(mmapped_data, this->data, this->size);
-  free(this->data);
-  this->data = mmapped_data;
-  this->data_is_mmapped = true;
-
-  /*
-   * fd is even not useful anymore and can be closed.
-   * Data are automatically write back to the file
-   * at random time during execution (depending of the kernel cache behavior)
-   * and, anyway, at the termination of the application.
-   */
-  close(fd);
-  return 0;
-}
-
-
-
 Hyperflash::Hyperflash(vp::ComponentConf &config)
 : vp::Component(config)
 {
@@ -434,9 +333,7 @@ Hyperflash::Hyperflash(vp::ComponentConf &config)
   this->size = conf->get("size")->get_int();
   this->trace.msg(vp::Trace::LEVEL_INFO, "Building flash (size: 0x%x)\n", this->size);
 
-  this->data = new uint8_t[this->size];
-  memset(this->data, 0xff, this->size);
-  this->data_is_mmapped = false;
+  this->storage = new FlashStorage(&this->trace, this->size, FLASH_SECTOR_SIZE);
 
   this->reg_data = new uint8_t[REGS_AREA_SIZE];
   memset(this->reg_data, 0x57, REGS_AREA_SIZE);
@@ -452,20 +349,19 @@ Hyperflash::Hyperflash(vp::ComponentConf &config)
     preload_file_conf = conf->get("content/image");
   }
 
-  if (preload_file_conf)
+  std::string preload_path = preload_file_conf ? preload_file_conf->get_str() : "";
+  bool writeback = conf->get_child_bool("writeback");
+  if (this->storage->init(preload_file_conf ? preload_path.c_str() : NULL, writeback))
   {
-    if (this->preload_file((char *)preload_file_conf->get_str().c_str()))
-    {
-      this->trace.fatal("Unable to preload file\n");
-      return;
-    }
+    this->trace.fatal("Unable to preload file\n");
+    return;
   }
 
   js::Config *writeback_file_conf = conf->get("writeback_file");
 
   if (writeback_file_conf)
   {
-    if (this->setup_writeback_file(writeback_file_conf->get_str().c_str()))
+    if (this->storage->set_writeback_file(writeback_file_conf->get_str().c_str()))
     {
       this->trace.fatal("Unable to preload file\n");
       return;
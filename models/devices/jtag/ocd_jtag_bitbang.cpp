@@ -30,6 +30,9 @@
 
 #include <vp/vp.hpp>
 
+// Maximum number of commands received and processed at once
+#define JTAG_BITBANG_BUFFER_SIZE 4096
+
 class Jtag : public vp::Component
 {
 public:
@@ -40,6 +43,7 @@ private:
 
     void proxy_listener();
     void proxy_loop(int sock);
+    bool handle_command(char command);
     bool open_proxy();
 
     void set_jtag_pads(int tck, int tms, int tdi, int trst);
@@ -76,9 +80,7 @@ Jtag::Jtag(vp::ComponentConf &config)
 void Jtag::set_jtag_pads(int tck, int tms, int tdi, int trst)
 {
     //fprintf(stderr, "PADS sync (tck: %d, tms: %d, tdi: %d, trst: %d)\n", tck, tms, tdi, trst);
-    this->time.get_engine()->lock();
     this->jtag_itf.sync(tck, tdi, tms, trst);
-    this->time.get_engine()->unlock();
 }
 
 
@@ -89,93 +91,123 @@ void Jtag::sync(vp::Block *__this, int tdo)
 }
 
 
+// Handle one remote_bitbang command. Must be called with the engine locked.
+// Returns true if the command expects TDO to be sent back.
+bool Jtag::handle_command(char command)
+{
+    switch (command)
+    {
+        case 'B':
+            //fprintf(stderr, "Blink ON\n");
+            break;
+        case 'b':
+            //fprintf(stderr, "Blink OFF\n");
+            break;
+        case 'r':
+            //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 0);
+            this->set_jtag_pads(0, 0, 0, 0);
+            break;
+        case 's':
+            //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 1);
+            this->set_jtag_pads(0, 0, 0, 0);
+            break;
+        case 't':
+            //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 1, 0);
+            this->set_jtag_pads(0, 0, 0, 1);
+            break;
+        case 'u':
+            //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 1);
+            this->set_jtag_pads(0, 0, 0, 1);
+            break;
+        case '0':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 0, 0);
+            this->set_jtag_pads(0, 0, 0, 0);
+            break;
+        case '1':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 0, 1);
+            this->set_jtag_pads(0, 0, 1, 0);
+            break;
+        case '2':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 1, 0);
+            this->set_jtag_pads(0, 1, 0, 0);
+            break;
+        case '3':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 1, 1);
+            this->set_jtag_pads(0, 1, 1, 0);
+            break;
+        case '4':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 0, 0);
+            this->set_jtag_pads(1, 0, 0, 0);
+            break;
+        case '5':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 0, 1);
+            this->set_jtag_pads(1, 0, 1, 0);
+            break;
+        case '6':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 1, 0);
+            this->set_jtag_pads(1, 1, 0, 0);
+            break;
+        case '7':
+            //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 1, 1);
+            this->set_jtag_pads(1, 1, 1, 0);
+            break;
+        case 'R':
+            //fprintf(stderr, "Read\n");
+            return true;
+        case 'Q':
+            fprintf(stderr, "Quit\n");
+            break;
+        default:
+            fprintf(stderr, "Received unknown command %c\n",
+                    command);
+    }
+
+    return false;
+}
+
+
 void Jtag::proxy_loop(int sock)
 {
+    char commands[JTAG_BITBANG_BUFFER_SIZE];
+    char replies[JTAG_BITBANG_BUFFER_SIZE];
+
     while(1)
     {
-        char command;
+        // Get as many commands as are available, OpenOCD usually sends a full scan at once
+        int size = recv(sock, (void *)commands, sizeof(commands), 0);
 
-        int ret = recv(sock, (void *)&command, sizeof(command), 0);
-
-        if (ret != sizeof(command))
+        if (size <= 0)
             return;
 
-        int reply = 0;
+        int nb_replies = 0;
 
-        switch (command)
+        // Process the whole run of commands with a single engine lock, the simulator cannot
+        // advance in between anyway since commands are not timed.
+        this->time.get_engine()->lock();
+        for (int i=0; i<size; i++)
         {
-            case 'B':
-                //fprintf(stderr, "Blink ON\n");
-                break;
-            case 'b':
-                //fprintf(stderr, "Blink OFF\n");
-                break;
-            case 'r':
-                //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 0);
-                this->set_jtag_pads(0, 0, 0, 0);
-                break;
-            case 's':
-                //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 1);
-                this->set_jtag_pads(0, 0, 0, 0);
-                break;
-            case 't':
-                //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 1, 0);
-                this->set_jtag_pads(0, 0, 0, 1);
-                break;
-            case 'u':
-                //fprintf(stderr, "Reset (trst: %d, srst: %d)\n", 0, 1);
-                this->set_jtag_pads(0, 0, 0, 1);
-                break;
-            case '0':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 0, 0);
-                this->set_jtag_pads(0, 0, 0, 0);
-                break;
-            case '1':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 0, 1);
-                this->set_jtag_pads(0, 0, 1, 0);
-                break;
-            case '2':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 1, 0);
-                this->set_jtag_pads(0, 1, 0, 0);
-                break;
-            case '3':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 0, 1, 1);
-                this->set_jtag_pads(0, 1, 1, 0);
-                break;
-            case '4':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 0, 0);
-                this->set_jtag_pads(1, 0, 0, 0);
-                break;
-            case '5':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 0, 1);
-                this->set_jtag_pads(1, 0, 1, 0);
-                break;
-            case '6':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 1, 0);
-                this->set_jtag_pads(1, 1, 0, 0);
-                break;
-            case '7':
-                //fprintf(stderr, "Write (tck: %d, tms: %d, tdi: %d)\n", 1, 1, 1);
-                this->set_jtag_pads(1, 1, 1, 0);
-                break;
-            case 'R':
-                //fprintf(stderr, "Read\n");
-                reply = 1;
-                break;
-            case 'Q':
-                fprintf(stderr, "Quit\n");
-                break;
-            default:
-                fprintf(stderr, "Received unknown command %c\n",
-                        command);
+            if (this->handle_command(commands[i]))
+            {
+                replies[nb_replies++] = this->tdo ? '1' : '0';
+            }
         }
-        if (reply)
+        this->time.get_engine()->unlock();
+
+        // OpenOCD waits for the replies of the read commands it sent before sending more, so
+        // they must all be sent before waiting for the next commands.
+        if (nb_replies)
         {
             //fprintf(stderr, "SEND TDO %d\n", this->tdo);
-            char reply_char = this->tdo ? '1' : '0';
-            ::send(sock, (void *)&reply_char, 1, 0);
+            char *reply = replies;
+            while (nb_replies)
+            {
+                int ret = ::send(sock, (void *)reply, nb_replies, 0);
+                if (ret <= 0)
+                    return;
+                reply += ret;
+                nb_replies -= ret;
+            }
         }
-
     }
 }
 
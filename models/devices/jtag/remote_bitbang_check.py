@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+
+#
+# Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and University of Bologna
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+#
+# Check of the remote_bitbang bridge (devices.jtag.ocd_jtag_bitbang).
+#
+# This connects to a running simulation with the bridge enabled and reads the IDCODE of the
+# first TAP of the chain, once with one command per send, as seen by the bridge before it
+# batched commands, and then with whole scans sent at once, including a run bigger than the
+# bridge buffer. All the TDO replies must be consistent between the two modes.
+#
+# Usage: remote_bitbang_check.py --port <bridge port> [--idcode <expected IDCODE>]
+#
+
+import argparse
+import socket
+import sys
+
+
+# Number of IDCODE scans sent in the same run of commands, so that the run is bigger than the
+# bridge buffer (4096 bytes)
+NB_BATCHED_SCANS = 64
+
+
+def clock(tms, tdi, read=False):
+    # Same sequence as OpenOCD: falling edge, optional read, rising edge
+    commands = '%d' % (tms * 2 + tdi)
+    if read:
+        commands += 'R'
+    return commands + '%d' % (4 + tms * 2 + tdi)
+
+
+def idcode_scan():
+    # Go through Test-Logic-Reset so that the IDCODE is selected, whatever the TAP state
+    commands = ''.join([clock(1, 0) for i in range(5)])
+    # Run-Test/Idle, Select-DR-Scan, Capture-DR, Shift-DR
+    commands += clock(0, 0) + clock(1, 0) + clock(0, 0) + clock(0, 0)
+    # Shift the 32 bits out, leaving to Exit1-DR on the last one
+    commands += ''.join([clock(1 if i == 31 else 0, 0, read=True) for i in range(32)])
+    # Update-DR, Run-Test/Idle
+    commands += clock(1, 0) + clock(0, 0)
+    return commands
+
+
+def recv_replies(sock, nb_replies):
+    replies = b''
+    while len(replies) < nb_replies:
+        data = sock.recv(nb_replies - len(replies))
+        if len(data) == 0:
+            raise RuntimeError('Connection closed with %d replies missing' %
+                (nb_replies - len(replies)))
+        replies += data
+
+    for reply in replies:
+        if reply not in b'01':
+            raise RuntimeError('Received invalid reply (reply: 0x%x)' % reply)
+
+    return replies.decode('ascii')
+
+
+def get_idcodes(replies):
+    # TDO is shifted out LSB first
+    return [int(replies[i:i+32][::-1], 2) for i in range(0, len(replies), 32)]
+
+
+def run_unbatched(sock, commands):
+    replies = ''
+    for command in commands:
+        sock.sendall(command.encode('ascii'))
+        if command == 'R':
+            replies += recv_replies(sock, 1)
+    return replies
+
+
+def run_batched(sock, commands):
+    sock.sendall(commands.encode('ascii'))
+    return recv_replies(sock, commands.count('R'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check the remote_bitbang JTAG bridge')
+
+    parser.add_argument("--host", dest="host", default='localhost', help="Host of the simulation")
+    parser.add_argument("--port", dest="port", required=True, type=int, help="Port of the bridge")
+    parser.add_argument("--idcode", dest="idcode", default=None, type=lambda x: int(x, 0), help="Expected IDCODE of the first TAP")
+
+    args = parser.parse_args()
+
+    sock = socket.create_connection((args.host, args.port))
+
+    # Release TRST
+    sock.sendall(b'u')
+
+    scan = idcode_scan()
+
+    reference = get_idcodes(run_unbatched(sock, scan))[0]
+    print('IDCODE: 0x%08x' % reference)
+
+    errors = 0
+
+    if args.idcode is not None and reference != args.idcode:
+        print('IDCODE mismatch (expected: 0x%08x)' % args.idcode)
+        errors += 1
+
+    # The IEEE 1149.1 IDCODE always has its LSB set, it is 0 if the TAP has no IDCODE and
+    # BYPASS is selected, or all 1s if nothing drives TDO
+    if reference & 1 == 0 or reference == 0xffffffff:
+        print('Invalid IDCODE, check that a TAP is connected to the bridge')
+        errors += 1
+
+    single = get_idcodes(run_batched(sock, scan))
+    if single != [reference]:
+        print('Batched scan mismatch (got: %s)' % ', '.join(['0x%08x' % x for x in single]))
+        errors += 1
+
+    commands = scan * NB_BATCHED_SCANS
+    batched = get_idcodes(run_batched(sock, commands))
+    nb_mismatches = len([x for x in batched if x != reference])
+    if len(batched) != NB_BATCHED_SCANS or nb_mismatches != 0:
+        print('Batched run mismatch (scans: %d, mismatches: %d, commands: %d bytes)' %
+            (len(batched), nb_mismatches, len(commands)))
+        errors += 1
+
+    sock.close()
+
+    print('%s (errors: %d)' % ('FAILED' if errors else 'PASSED', errors))
+
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
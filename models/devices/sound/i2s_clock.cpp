@@ -68,7 +68,10 @@ void I2s_clock::start()
     if (frequency != 0)
     {
         this->clock_cfg.set_frequency(frequency);
-        this->event_enqueue(this->event, 1);
+        // I2S receivers sample data on each sck edge, so they still need one call per edge.
+        // The event is kept enabled so that it is executed on each cycle without being
+        // enqueued again.
+        this->event->enable();
     }
 }
 
@@ -87,8 +90,6 @@ void I2s_clock::handler(vp::Block *__this, vp::ClockEvent *event)
     }
 
     _this->sck ^= 1;
-
-    _this->event_enqueue(_this->event, 1);
 }
 
 
@@ -25,6 +25,9 @@
 #include "pcm_pdm_conversion.hpp"
 #include "io_audio.h"
 
+// Number of PCM samples converted at once into PDM bits
+#define PCM_BLOCK_SIZE 16
+
 
 
 class Microphone_pdm : public vp::Component
@@ -115,7 +118,7 @@ void Microphone_pdm::restart_input_audio_stream(){
     delete pcm2pdm;
 
     audio_stream_in = new Signal_generator(generated_freq, this->i2s_freq / 64);
-    pcm2pdm = new PcmToPdm(6, 0); // interpolation ratio 64 and interpolation type LINEAR
+    pcm2pdm = new PcmToPdm(6, 0, PCM_BLOCK_SIZE); // interpolation ratio 64 and interpolation type LINEAR
 }
 
 
@@ -216,11 +219,16 @@ int64_t Microphone_pdm::exec()
         {
             if (this->audio_stream_in)
             {
-                int32_t pcm_data;
-                pcm_data = audio_stream_in->get_sample(); // here data is a int32
+                // The stream is private to this microphone, so we can read a block of samples
+                // ahead and convert them at once
+                int32_t pcm_data[PCM_BLOCK_SIZE];
+                for (int i=0; i<PCM_BLOCK_SIZE; i++)
+                {
+                    pcm_data[i] = audio_stream_in->get_sample(); // here data is a int32
+                }
                 // convert it to pdm
                 got_pcm_data = true;
-                this->pcm2pdm->convert(pcm_data);
+                this->pcm2pdm->convert_block(pcm_data, PCM_BLOCK_SIZE);
             }
             else
             {
@@ -234,9 +242,7 @@ int64_t Microphone_pdm::exec()
         }
         if (got_pcm_data)
         {
-            data = (int)this->pcm2pdm->pdm_output[cmpt++];
-            // pdm data must be 0/1
-            data = (data <= 0) ? 0 : 1;
+            data = this->pcm2pdm->get_pdm_bit(cmpt++);
         }
         else
         {
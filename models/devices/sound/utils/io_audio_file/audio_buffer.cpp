@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include "audio_buffer.hpp"
+
+
+Audio_buffered_reader::Audio_buffered_reader(int nb_channels, Audio_read_frames_meth read_frames,
+    int64_t block_frames, int nb_blocks)
+: nb_channels(nb_channels), read_frames(read_frames)
+{
+    this->block_frames = block_frames > 0 ? block_frames : AUDIO_BUFFER_DEFAULT_BLOCK_FRAMES;
+    if (nb_blocks <= 0)
+    {
+        nb_blocks = AUDIO_BUFFER_DEFAULT_NB_BLOCKS;
+    }
+
+    for (int i=0; i<nb_blocks; i++)
+    {
+        Audio_block *block = new Audio_block(this->block_frames * nb_channels);
+        this->blocks.push_back(block);
+        this->free_blocks.push(block);
+    }
+
+    this->zero_frame = new int32_t[nb_channels];
+    memset(this->zero_frame, 0, sizeof(int32_t) * nb_channels);
+
+    this->thread = new std::thread(&Audio_buffered_reader::thread_routine, this);
+}
+
+
+Audio_buffered_reader::~Audio_buffered_reader()
+{
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->stop = true;
+        this->cond.notify_all();
+    }
+
+    this->thread->join();
+    delete this->thread;
+
+    for (Audio_block *block: this->blocks)
+    {
+        delete block;
+    }
+    delete[] this->zero_frame;
+}
+
+
+int32_t *Audio_buffered_reader::get_frame_from_next_block()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // Give back the block we just finished so that the helper thread can refill it
+    if (this->current_block)
+    {
+        this->free_blocks.push(this->current_block);
+        this->current_block = NULL;
+        this->cond.notify_all();
+    }
+
+    while (this->ready_blocks.empty() && !this->end_of_file)
+    {
+        this->cond.wait(lock);
+    }
+
+    if (this->ready_blocks.empty())
+    {
+        return this->zero_frame;
+    }
+
+    this->current_block = this->ready_blocks.front();
+    this->ready_blocks.pop();
+    this->current_frame = 1;
+
+    return this->current_block->frames;
+}
+
+
+void Audio_buffered_reader::thread_routine()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (!this->stop)
+    {
+        if (this->free_blocks.empty())
+        {
+            this->cond.wait(lock);
+            continue;
+        }
+
+        Audio_block *block = this->free_blocks.front();
+        this->free_blocks.pop();
+
+        // The file is only accessed from this thread, no need to keep the lock while reading
+        lock.unlock();
+        block->nb_frames = this->read_frames(block->frames, this->block_frames);
+        lock.lock();
+
+        if (block->nb_frames == 0)
+        {
+            this->free_blocks.push(block);
+            this->end_of_file = true;
+            this->cond.notify_all();
+            break;
+        }
+
+        this->ready_blocks.push(block);
+        this->cond.notify_all();
+    }
+}
+
+
+Audio_buffered_writer::Audio_buffered_writer(int nb_channels, Audio_write_frames_meth write_frames,
+    int64_t block_frames, int nb_blocks)
+: nb_channels(nb_channels), write_frames(write_frames)
+{
+    this->block_frames = block_frames > 0 ? block_frames : AUDIO_BUFFER_DEFAULT_BLOCK_FRAMES;
+    if (nb_blocks <= 0)
+    {
+        nb_blocks = AUDIO_BUFFER_DEFAULT_NB_BLOCKS;
+    }
+
+    for (int i=0; i<nb_blocks; i++)
+    {
+        Audio_block *block = new Audio_block(this->block_frames * nb_channels);
+        this->blocks.push_back(block);
+        this->free_blocks.push(block);
+    }
+
+    this->thread = new std::thread(&Audio_buffered_writer::thread_routine, this);
+}
+
+
+Audio_buffered_writer::~Audio_buffered_writer()
+{
+    this->flush();
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->stop = true;
+        this->cond.notify_all();
+    }
+
+    this->thread->join();
+    delete this->thread;
+
+    for (Audio_block *block: this->blocks)
+    {
+        delete block;
+    }
+}
+
+
+void Audio_buffered_writer::push_frame(const int32_t *frame)
+{
+    if (this->current_block == NULL)
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while (this->free_blocks.empty())
+        {
+            this->cond.wait(lock);
+        }
+        this->current_block = this->free_blocks.front();
+        this->free_blocks.pop();
+        this->current_block->nb_frames = 0;
+    }
+
+    memcpy(&this->current_block->frames[this->current_block->nb_frames * this->nb_channels],
+        frame, sizeof(int32_t) * this->nb_channels);
+    this->current_block->nb_frames++;
+
+    if (this->current_block->nb_frames == this->block_frames)
+    {
+        this->push_current_block();
+    }
+}
+
+
+void Audio_buffered_writer::push_current_block()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->ready_blocks.push(this->current_block);
+    this->current_block = NULL;
+    this->cond.notify_all();
+}
+
+
+void Audio_buffered_writer::flush()
+{
+    if (this->current_block)
+    {
+        if (this->current_block->nb_frames > 0)
+        {
+            this->push_current_block();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->free_blocks.push(this->current_block);
+            this->current_block = NULL;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (this->free_blocks.size() != this->blocks.size())
+    {
+        this->cond.wait(lock);
+    }
+}
+
+
+void Audio_buffered_writer::thread_routine()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while (1)
+    {
+        if (this->ready_blocks.empty())
+        {
+            if (this->stop)
+            {
+                break;
+            }
+            this->cond.wait(lock);
+            continue;
+        }
+
+        Audio_block *block = this->ready_blocks.front();
+        this->ready_blocks.pop();
+
+        // The file is only accessed from this thread, no need to keep the lock while writing
+        lock.unlock();
+        this->write_frames(block->frames, block->nb_frames);
+        lock.lock();
+
+        this->free_blocks.push(block);
+        this->cond.notify_all();
+    }
+}
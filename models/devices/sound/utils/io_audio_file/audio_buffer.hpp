@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// Default number of frames per block and number of blocks used when the caller does not
+// specify them.
+#define AUDIO_BUFFER_DEFAULT_BLOCK_FRAMES 4096
+#define AUDIO_BUFFER_DEFAULT_NB_BLOCKS    4
+
+
+// Reads up to nb_frames frames into buffer and returns the number of frames actually read.
+// Returning 0 means end of file.
+typedef std::function<int64_t(int32_t *buffer, int64_t nb_frames)> Audio_read_frames_meth;
+
+// Writes nb_frames frames from buffer.
+typedef std::function<void(const int32_t *buffer, int64_t nb_frames)> Audio_write_frames_meth;
+
+
+class Audio_block
+{
+public:
+    Audio_block(int64_t size) { this->frames = new int32_t[size]; }
+    ~Audio_block() { delete[] this->frames; }
+
+    int32_t *frames;
+    int64_t nb_frames = 0;
+};
+
+
+/**
+ * @brief Block-buffered audio frame reader
+ *
+ * Frames are read by blocks from a helper thread, ahead of the simulation, so that getting a
+ * frame from the simulation thread is most of the time just a memory access.
+ * Once the end of file is reached, frames filled with zeros are returned.
+ */
+class Audio_buffered_reader
+{
+public:
+    /**
+     * @brief Construct a new reader
+     *
+     * @param nb_channels Number of 32bits items per frame.
+     * @param read_frames Method called from the helper thread to read frames from the file.
+     * @param block_frames Number of frames per block, 0 for the default.
+     * @param nb_blocks Number of blocks, 0 for the default.
+     */
+    Audio_buffered_reader(int nb_channels, Audio_read_frames_meth read_frames,
+        int64_t block_frames=0, int nb_blocks=0);
+    ~Audio_buffered_reader();
+
+    /**
+     * @brief Get the next frame
+     *
+     * The returned frame contains one item per channel and is valid until the next call.
+     */
+    inline int32_t *get_frame()
+    {
+        if (this->current_block && this->current_frame < this->current_block->nb_frames)
+        {
+            return &this->current_block->frames[(this->current_frame++) * this->nb_channels];
+        }
+        return this->get_frame_from_next_block();
+    }
+
+private:
+    int32_t *get_frame_from_next_block();
+    void thread_routine();
+
+    int nb_channels;
+    int64_t block_frames;
+    Audio_read_frames_meth read_frames;
+    std::vector<Audio_block *> blocks;
+    // Blocks which can be filled by the helper thread
+    std::queue<Audio_block *> free_blocks;
+    // Blocks filled by the helper thread, in file order
+    std::queue<Audio_block *> ready_blocks;
+    // Block from which frames are currently returned
+    Audio_block *current_block = NULL;
+    int64_t current_frame = 0;
+    int32_t *zero_frame;
+    bool end_of_file = false;
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread *thread;
+};
+
+
+/**
+ * @brief Block-buffered audio frame writer
+ *
+ * Frames are accumulated into blocks which are written to the file from a helper thread, so
+ * that pushing a frame from the simulation thread is most of the time just a memory copy.
+ * Frames are written in the order they are pushed and all of them are written when the writer
+ * is flushed or destroyed.
+ */
+class Audio_buffered_writer
+{
+public:
+    /**
+     * @brief Construct a new writer
+     *
+     * @param nb_channels Number of 32bits items per frame.
+     * @param write_frames Method called from the helper thread to write frames to the file.
+     * @param block_frames Number of frames per block, 0 for the default.
+     * @param nb_blocks Number of blocks, 0 for the default.
+     */
+    Audio_buffered_writer(int nb_channels, Audio_write_frames_meth write_frames,
+        int64_t block_frames=0, int nb_blocks=0);
+    ~Audio_buffered_writer();
+
+    /**
+     * @brief Push a frame
+     *
+     * The frame must contain one item per channel and is copied.
+     */
+    void push_frame(const int32_t *frame);
+
+    /**
+     * @brief Wait until all pushed frames have been written to the file
+     */
+    void flush();
+
+private:
+    void push_current_block();
+    void thread_routine();
+
+    int nb_channels;
+    int64_t block_frames;
+    Audio_write_frames_meth write_frames;
+    std::vector<Audio_block *> blocks;
+    std::queue<Audio_block *> free_blocks;
+    // Blocks waiting to be written by the helper thread, in file order
+    std::queue<Audio_block *> ready_blocks;
+    // Block currently filled by the simulation thread
+    Audio_block *current_block = NULL;
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread *thread;
+};
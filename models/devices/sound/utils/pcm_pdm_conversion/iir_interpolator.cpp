@@ -70,6 +70,20 @@ int32_t IIR_interpolator(int32_t input, int32_t *output, iir_interpolator_contex
     return (my_context->interpolation_ratio);
 }
 
+/*
+ * Block version of IIR_interpolator, producing interpolation_ratio output samples per input
+ * sample. The biquad cascade is recursive and is thus still computed sample by sample.
+ */
+int32_t IIR_interpolator_block(const int32_t *input, int nb_samples, int32_t *output, iir_interpolator_context *my_context)
+{
+    for (int sample_index = 0; sample_index < nb_samples; sample_index++)
+    {
+        IIR_interpolator(input[sample_index], &output[sample_index * my_context->interpolation_ratio], my_context);
+    }
+
+    return (nb_samples * my_context->interpolation_ratio);
+}
+
 /****************************************************************************
  * Implementation of IIR direct form I fixed point.
  *
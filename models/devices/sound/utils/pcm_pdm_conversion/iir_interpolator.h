@@ -44,4 +44,5 @@ typedef struct iir_interpolator_context
 
 
 extern int32_t  IIR_interpolator(int32_t input, int32_t *output, iir_interpolator_context *my_context );
+extern int32_t  IIR_interpolator_block(const int32_t *input, int nb_samples, int32_t *output, iir_interpolator_context *my_context );
 #endif
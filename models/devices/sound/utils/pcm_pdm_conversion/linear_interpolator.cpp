@@ -45,4 +45,31 @@ int32_t linear_interpolator(int32_t input, int32_t *output, linear_interpolator_
     return(my_context->interpolation_ratio);
     }
 
+/*
+ * Block version of linear_interpolator, producing interpolation_ratio output samples per input
+ * sample. The running sum of the scalar version is replaced by a multiplication by the sample
+ * index, computed modulo 2^32 like the running sum, so that the inner loop has no dependency
+ * between iterations and can be vectorized.
+ */
+int32_t linear_interpolator_block(const int32_t *input, int nb_samples, int32_t *output, linear_interpolator_context *my_context )
+    {
+    int ratio = my_context->interpolation_ratio;
+
+    for(int sample_index = 0; sample_index < nb_samples; sample_index++)
+        {
+        int32_t delta = SIGNED_SHIFT_LEFT((input[sample_index] - my_context->previous_sample) , - my_context->ratio_shift);
+        uint32_t previous_sample = (uint32_t)my_context->previous_sample;
+        int32_t *sample_output = &output[sample_index * ratio];
+
+        for(int output_index = 0; output_index < ratio; output_index++)
+            {
+            sample_output[output_index] = (int32_t)(previous_sample + (uint32_t)(output_index + 1) * (uint32_t)delta);
+            }
+        sample_output[ratio-1] = input[sample_index];
+        my_context->previous_sample = input[sample_index];
+        }
+
+    return(nb_samples * ratio);
+    }
+
 //TODO: Need to add method to reset the filter history
@@ -33,4 +33,5 @@ typedef struct linear_interpolator_context
 
 
 extern int32_t  linear_interpolator(int32_t input, int32_t *output, linear_interpolator_context *my_context );
+extern int32_t  linear_interpolator_block(const int32_t *input, int nb_samples, int32_t *output, linear_interpolator_context *my_context );
 #endif
@@ -25,30 +25,19 @@ int PdmToPcm::convert(int32_t input_bit)
 }
 
 
-void PcmToPdm::convert(int32_t pcm_data)
+void PcmToPdm::convert_block(const int32_t *pcm_data, int32_t nb_samples)
 {
-    output_index = 0;
     if (interpolation_type == IIR)
     {
-        nb_generated_samples = IIR_interpolator(pcm_data, this->interpolated_samples, &this->iir_context);
+        nb_generated_samples = IIR_interpolator_block(pcm_data, nb_samples, this->interpolated_samples, &this->iir_context);
     }
     else
     {
-        nb_generated_samples = linear_interpolator(pcm_data, this->interpolated_samples, &this->linear_context);
+        nb_generated_samples = linear_interpolator_block(pcm_data, nb_samples, this->interpolated_samples, &this->linear_context);
     }
-    for (int index_interpolated = 0; index_interpolated < nb_generated_samples; index_interpolated++) // interpolated sample loop
-    {
-        sigma_delta_modulator(interpolated_samples[index_interpolated], &output[output_index], my_delay_line);
-        if (output[output_index] <= 0)
-        {
-            pdm_output[output_index] = 0;
-        }
-        else
-        {
-            pdm_output[output_index] = 1;
-        }
-        output_index++;
-    } // interpolated sample loop
+
+    sigma_delta_modulator_block(this->interpolated_samples, nb_generated_samples, this->pdm_bits, my_delay_line);
+    output_size = nb_generated_samples;
 }
 
 
@@ -70,21 +59,22 @@ PdmToPcm::PdmToPcm(int32_t cic_r, int32_t cic_n, int32_t cic_m, int32_t cic_shif
 
 
 
-PcmToPdm::PcmToPdm(uint8_t interpolation_ratio_shift, uint8_t interp_type)
+PcmToPdm::PcmToPdm(uint8_t interpolation_ratio_shift, uint8_t interp_type, int32_t max_block_samples)
 {
-    int8_t iir_interpolator_shift_in[NB_STAGES] = {0, 0, 0, 0};
-    int8_t iir_interpolator_shift_out[NB_STAGES] = {0, 0, 0, 0};
-    int8_t iir_interpolator_shift_end[1] = {3};
-    int32_t iir_interpolator_MA[NB_STAGES][NB_COEF_MA] = {{709185228, -1408142929, 709185228},
+    // These tables are referenced by the IIR context and must outlive this constructor
+    static int8_t iir_interpolator_shift_in[NB_STAGES] = {0, 0, 0, 0};
+    static int8_t iir_interpolator_shift_out[NB_STAGES] = {0, 0, 0, 0};
+    static int8_t iir_interpolator_shift_end[1] = {3};
+    static int32_t iir_interpolator_MA[NB_STAGES][NB_COEF_MA] = {{709185228, -1408142929, 709185228},
                                                           {1076329801, -2147002896, 1076329801},
                                                           {668750479, -1265161595, 668750479},
                                                           {852379081, -1698836148, 852379081}};
-    int8_t iir_interpolator_shift_left_MA[NB_STAGES] = {-3 - 31, -2 - 31, -5 - 31, -1 - 31};
-    int32_t iir_interpolator_AR[NB_STAGES][NB_COEF_AR] = {{-2122974449, 1050082652},
+    static int8_t iir_interpolator_shift_left_MA[NB_STAGES] = {-3 - 31, -2 - 31, -5 - 31, -1 - 31};
+    static int32_t iir_interpolator_AR[NB_STAGES][NB_COEF_AR] = {{-2122974449, 1050082652},
                                                           {-2141102846, 1069256467},
                                                           {-2116554201, 1043129460},
                                                           {-2132062194, 1059818016}};
-    int8_t iir_interpolator_shift_left_AR[NB_STAGES] = {1 - 31, 1 - 31, 1 - 31, 1 - 31};
+    static int8_t iir_interpolator_shift_left_AR[NB_STAGES] = {1 - 31, 1 - 31, 1 - 31, 1 - 31};
 
     /* default: out belong to (-1,1) couple*/
     if (interp_type == LINEAR)
@@ -115,11 +105,11 @@ PcmToPdm::PcmToPdm(uint8_t interpolation_ratio_shift, uint8_t interp_type)
     linear_context.interpolation_ratio = (1 << interpolation_ratio_shift); /* integer interpolation ratio for 0 insertion                           */
     linear_context.ratio_shift = interpolation_ratio_shift;
     iir_context.interpolation_ratio = 1 << interpolation_ratio_shift;
-    output_size = linear_context.interpolation_ratio;
+    this->max_block_samples = max_block_samples;
+    int32_t max_output_size = max_block_samples << interpolation_ratio_shift;
 
-    interpolated_samples = new int32_t[linear_context.interpolation_ratio]();
-    output = new int32_t[output_size]();
-    pdm_output = new int8_t[output_size]();
+    interpolated_samples = new int32_t[max_output_size]();
+    pdm_bits = new uint64_t[(max_output_size + 63) / 64]();
 
 #ifdef DEBUG_CONVERSION
     file_debug_pcm_got = fopen("file_debug_pcm_got", "wb");
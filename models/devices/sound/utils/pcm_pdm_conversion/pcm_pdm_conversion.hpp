@@ -43,13 +43,15 @@ typedef struct
 
 
 // Class for the PCM to PDM conversion
+//
+// PCM samples are converted by blocks. Each PCM sample gives (1 << interpolation_ratio_shift) PDM
+// bits, which are stored into a bit buffer and can then be retrieved with get_pdm_bit.
 class PcmToPdm
 {
 private:
     int32_t nb_generated_samples;
-    int32_t nb_samples_in;
     int32_t local_ratio_shift;
-    int32_t output_index = 0;
+    int32_t max_block_samples;
     interpolator_type interpolation_type;
     iir_interpolator_context iir_context;
     linear_interpolator_context linear_context;
@@ -64,22 +66,26 @@ private:
 #endif
 
 public:
+    // Number of PDM bits produced by the last conversion
     int32_t output_size = 0;
-    int32_t *output = NULL;
-    int8_t *pdm_output = NULL;
+    // PDM bits produced by the last conversion, bit i is bit (i % 64) of word (i / 64)
+    uint64_t *pdm_bits = NULL;
 #ifdef DEBUG_CONVERSION
     void debug_pcm_got(int32_t pcm);  // store pcm data that must be converted into a file int32_t
     void debug_pdm_produced(int32_t pdm);  // store pdm data that has been converted into a file (in int8_t)
 #endif
 
-    PcmToPdm(uint8_t interpolation_ratio_shift, uint8_t interpolation_type);
-    void convert(int32_t pcm_data);
+    PcmToPdm(uint8_t interpolation_ratio_shift, uint8_t interpolation_type, int32_t max_block_samples=1);
+    // Convert nb_samples PCM samples, at most max_block_samples, into output_size PDM bits
+    void convert_block(const int32_t *pcm_data, int32_t nb_samples);
+    void convert(int32_t pcm_data) { this->convert_block(&pcm_data, 1); }
+    // Return PDM bit at the specified index from the last conversion, as 0 or 1
+    inline int get_pdm_bit(int32_t index) { return (this->pdm_bits[index >> 6] >> (index & 63)) & 1; }
     ~PcmToPdm()
     {
         delete[] iir_context.filter_state;
         delete[] interpolated_samples;
-        delete[] output;
-        delete[] pdm_output;
+        delete[] pdm_bits;
 #ifdef DEBUG_CONVERSION
         fclose(file_debug_pcm_got);
         fclose(file_debug_pdm_produced);
@@ -57,6 +57,65 @@ void sigma_delta_modulator(int32_t input,int32_t *output, int64_t *delay_line)
 
     }
 
+/*
+ * Block version of sigma_delta_modulator, producing one PDM bit per input sample into
+ * output_bits (bit i of the block is bit (i % 64) of word (i / 64), 1 for a positive PDM
+ * output). The modulator is computed exactly as in cascade_of_resonator_feedforward, but the
+ * coefficients are constants and the state is kept in local variables during the whole block,
+ * instead of being reloaded from the delay line for every sample.
+ */
+void sigma_delta_modulator_block(const int32_t *input, int nb_samples, uint64_t *output_bits, int64_t *delay_line)
+    {
+    const int64_t forward_coefficient_0 = 5540;
+    const int64_t forward_coefficient_1 = 70669;
+    const int64_t forward_coefficient_2 = 458739;
+    const int64_t forward_coefficient_3 = 2098672;
+    const int64_t forward_coefficient_4 = 4665325;
+    const int64_t forward_coefficient_5 = 8388608;
+    const int64_t loopback_gain_0 = 4248414;
+    const int64_t loopback_gain_1 = 1500259;
+    const int     loopback_gain_shift = 8;
+    const int64_t pdm_one = ((int64_t)1) << (PRECISION+SHIFT_12dB);
+
+    int64_t stage_output_0 = delay_line[0];
+    int64_t stage_output_1 = delay_line[1];
+    int64_t stage_output_2 = delay_line[2];
+    int64_t stage_output_3 = delay_line[3];
+    int64_t stage_output_4 = delay_line[4];
+    int64_t stage_output_5 = delay_line[5];
+    int64_t pdm_output     = delay_line[CRFB_ORDER+1];
+
+    for(int i=0; i<(nb_samples + 63) / 64; i++)
+        {
+        output_bits[i] = 0;
+        }
+
+    for(int i=0; i<nb_samples; i++)
+        {
+        int64_t pcm_input = input[i];
+
+        stage_output_1 = stage_output_1 + (pcm_input * forward_coefficient_1) - (pdm_output * forward_coefficient_1) - ((loopback_gain_0 * (stage_output_2>>PRECISION))>>loopback_gain_shift) + stage_output_0;
+        stage_output_3 = stage_output_3 + (pcm_input * forward_coefficient_3) - (pdm_output * forward_coefficient_3) - ((loopback_gain_1 * (stage_output_4>>PRECISION))>>loopback_gain_shift) + stage_output_2;
+
+        stage_output_5 = (pcm_input * forward_coefficient_5) + stage_output_4;
+        pdm_output = (stage_output_5 >= 0) ? pdm_one : -pdm_one;
+
+        stage_output_0 = stage_output_0 + (pcm_input * forward_coefficient_0) - (pdm_output * forward_coefficient_0);
+        stage_output_2 = stage_output_2 + (pcm_input * forward_coefficient_2) - (pdm_output * forward_coefficient_2) + stage_output_1;
+        stage_output_4 = stage_output_4 + (pcm_input * forward_coefficient_4) - (pdm_output * forward_coefficient_4) + stage_output_3;
+
+        output_bits[i >> 6] |= ((uint64_t)(pdm_output >= 0)) << (i & 63);
+        }
+
+    delay_line[0] = stage_output_0;
+    delay_line[1] = stage_output_1;
+    delay_line[2] = stage_output_2;
+    delay_line[3] = stage_output_3;
+    delay_line[4] = stage_output_4;
+    delay_line[5] = stage_output_5;
+    delay_line[CRFB_ORDER+1] = pdm_output;
+    }
+
 void sigma_delta_first_order_modulator(int32_t input,int32_t *output, int32_t *delay_line)
     {
     int32_t residual=0;
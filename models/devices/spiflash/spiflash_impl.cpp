@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <vp/itf/qspim.hpp>
+#include <flash_storage.hpp>
 
 #define CMD_READ_ID       0x9f
 #define CMD_RDCR          0x35
@@ -42,6 +43,8 @@
 #define CMD_SECTOR_ERASE  0xD8
 #define CMD_READ_SR2V     0x07
 
+#define SPIFLASH_SECTOR_SIZE (1<<16)
+
 class spiflash;
 
 typedef struct {
@@ -121,10 +124,10 @@ private:
   
   vp::Trace     trace;
 
-  int size;
+  unsigned int size;
 
   command_t *commands[256];
-  uint8_t *mem_data;
+  FlashStorage *storage;
   unsigned int pending_word;
   unsigned int pending_addr;
   int pending_bits;
@@ -192,7 +195,7 @@ void spiflash::page_program(vp::Block *__this, int data_0, int data_1, int data_
 
       _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Writing byte (address: 0x%x, value: 0x%x)\n", _this->current_addr, (uint8_t)_this->pending_word);
 
-      _this->mem_data[_this->current_addr++] = _this->pending_word;
+      _this->storage->write(_this->current_addr++, _this->pending_word);
     }
   }
 }
@@ -219,6 +222,10 @@ void spiflash::sector_erase(vp::Block *__this, int data_0, int data_1, int data_
   {
     _this->current_addr = _this->pending_word;
     _this->trace.msg(vp::Trace::LEVEL_INFO, "Received address (address: 0x%x)\n", _this->current_addr);
+    if (_this->current_addr < _this->size)
+    {
+      _this->storage->erase_sector(_this->current_addr);
+    }
     _this->event_enqueue(_this->sector_erase_event, 1000000);
   }
 
@@ -273,7 +280,7 @@ void spiflash::quad_read(vp::Block *__this, int data_0, int data_1, int data_2,
         return;
       }
 
-      _this->pending_word = _this->mem_data[_this->current_addr++];
+      _this->pending_word = _this->storage->read(_this->current_addr++);
     }
   }
 
@@ -303,7 +310,7 @@ void spiflash::single_read(vp::Block *__this, int data_0, int data_1, int data_2
         return;
       }
 
-      _this->pending_word = _this->mem_data[_this->current_addr++];
+      _this->pending_word = _this->storage->read(_this->current_addr++);
     }
   }
 
@@ -463,9 +470,7 @@ spiflash::spiflash(vp::ComponentConf &config)
 
   this->size = this->get_js_config()->get_child_int("size");
 
-  this->mem_data = new uint8_t[this->size];
-
-  memset(this->mem_data, 0x57, this->size);
+  this->storage = new FlashStorage(&this->trace, this->size, SPIFLASH_SECTOR_SIZE);
 
   this->cr1.raw = 0;
   this->quad = false;
@@ -487,22 +492,12 @@ spiflash::spiflash(vp::ComponentConf &config)
     stim_file_conf = this->get_js_config()->get("preload_file");
   }
 
-  if (stim_file_conf != NULL)
+  string path = stim_file_conf != NULL ? stim_file_conf->get_str() : "";
+  bool writeback = this->get_js_config()->get_child_bool("writeback");
+  if (this->storage->init(stim_file_conf != NULL ? path.c_str() : NULL, writeback))
   {
-    string path = stim_file_conf->get_str();
-    this->trace.msg(vp::Trace::LEVEL_INFO, "Preloading memory with stimuli file (path: %s)\n", path.c_str());
-
-    FILE *file = fopen(path.c_str(), "rb");
-    if (file == NULL)
-    {
-      this->trace.fatal("Unable to open stim file: %s, %s\n", path.c_str(), strerror(errno));
-      return;
-    }
-    if (fread(this->mem_data, 1, size, file) == 0)
-    {
-      this->trace.fatal("Failed to read stim file: %s, %s\n", path.c_str(), strerror(errno));
-      return;
-    }
+    this->trace.fatal("Unable to preload file\n");
+    return;
   }
 
   js::Config *slm_stim_file_conf = this->get_js_config()->get("slm_stim_file");
@@ -527,7 +522,7 @@ spiflash::spiflash(vp::ComponentConf &config)
         this->trace.fatal("Incorrect stimuli file (path: %s)\n", path.c_str());
         return;
       }
-      if (addr < size) this->mem_data[addr] = value;
+      if (addr < size) this->storage->write(addr, value);
     }
   }
 }
@@ -30,6 +30,7 @@
 #endif
 
 #include "pcm_pdm_conversion.hpp"
+#include "audio_buffer.hpp"
 
 class Slot;
 
@@ -56,6 +57,7 @@ class Rx_stream_libsnd_file : public Rx_stream
 {
 public:
     Rx_stream_libsnd_file(I2s_verif *i2s, pi_testbench_i2s_verif_start_config_rx_file_reader_type_e type, string filepath, int nb_channels, int width);
+    ~Rx_stream_libsnd_file();
     uint32_t get_sample(int channel_id);
     I2s_verif *i2s;
 
@@ -64,6 +66,7 @@ private:
     SNDFILE *sndfile;
     SF_INFO sfinfo;
 #endif
+    Audio_buffered_reader *reader = NULL;
     int period;
     int width;
     uint32_t pending_channels;
@@ -81,11 +84,14 @@ class Rx_stream_raw_file : public Rx_stream
 {
 public:
     Rx_stream_raw_file(Slot *slot, string filepath, int width, bool is_bin, pi_testbench_i2s_verif_start_config_file_encoding_type_e encoding);
+    ~Rx_stream_raw_file();
     uint32_t get_sample(int channel_id);
     Slot *slot;
 
 private:
     FILE *infile;
+    // Only used in binary mode, where samples are read by blocks
+    Audio_buffered_reader *reader = NULL;
     int width;
     bool is_bin;
     pi_testbench_i2s_verif_start_config_file_encoding_type_e encoding;
@@ -96,11 +102,14 @@ class Tx_stream_raw_file : public Tx_stream
 {
 public:
     Tx_stream_raw_file(Slot *slot, string filepath, int width, bool is_bin, pi_testbench_i2s_verif_start_config_file_encoding_type_e encoding);
+    ~Tx_stream_raw_file();
     void push_sample(uint32_t sample, int channel_id);
     Slot *slot;
 
 private:
     FILE *outfile;
+    // Only used in binary mode, where samples are written by blocks
+    Audio_buffered_writer *writer = NULL;
     int width;
     bool is_bin;
     pi_testbench_i2s_verif_start_config_file_encoding_type_e encoding;
@@ -120,6 +129,7 @@ private:
     SNDFILE *sndfile;
     SF_INFO sfinfo;
 #endif
+    Audio_buffered_writer *writer = NULL;
     int period;
     int width;
     uint32_t pending_channels;
@@ -137,6 +147,18 @@ private:
 };
 
 
+// Block sizes used for buffered audio file accesses, taken from the testbench configuration.
+static int64_t audio_buffer_block_frames(Testbench *top)
+{
+    return top->get_js_config()->get_child_int("audio_buffer/block_frames");
+}
+
+static int audio_buffer_nb_blocks(Testbench *top)
+{
+    return top->get_js_config()->get_child_int("audio_buffer/nb_blocks");
+}
+
+
 class Slot : public vp::Block
 {
     friend class Rx_stream_libsnd_file;
@@ -148,6 +170,8 @@ public:
     void setup(pi_testbench_i2s_verif_slot_config_t *config);
     void start(pi_testbench_i2s_verif_slot_start_config_t *config, Slot *reuse_slot = NULL, int nb_channels=1, int channel_id=0);
     void stop(pi_testbench_i2s_verif_slot_stop_config_t *config);
+    // Called at the end of the simulation to write out and close the TX stream
+    void stop();
     void start_frame();
     int get_data();
     void send_data(int sdo);
@@ -602,6 +626,34 @@ Tx_stream_raw_file::Tx_stream_raw_file(Slot *slot, std::string filepath, int wid
     if (this->outfile == NULL)
     {
         this->slot->top->trace.fatal("Unable to open output file (file: %s, error: %s)\n", filepath.c_str(), strerror(errno));
+        return;
+    }
+
+    if (this->is_bin)
+    {
+        int nb_bytes = (this->width + 7) / 8;
+        FILE *outfile = this->outfile;
+        this->writer = new Audio_buffered_writer(1,
+            [outfile, nb_bytes](const int32_t *frames, int64_t nb_frames) {
+                for (int64_t i=0; i<nb_frames; i++)
+                {
+                    if (fwrite((void *)&frames[i], nb_bytes, 1, outfile) != 1)
+                    {
+                        return;
+                    }
+                }
+            },
+            audio_buffer_block_frames(slot->top), audio_buffer_nb_blocks(slot->top));
+    }
+}
+
+
+Tx_stream_raw_file::~Tx_stream_raw_file()
+{
+    delete this->writer;
+    if (this->outfile)
+    {
+        fclose(this->outfile);
     }
 }
 
@@ -621,11 +673,7 @@ void Tx_stream_raw_file::push_sample(uint32_t sample, int channel_id)
                 sample = 0; // Error
         }
 
-        int nb_bytes = (this->width + 7) / 8;
-        if (fwrite((void *)&sample, nb_bytes, 1, this->outfile) != 1)
-        {
-            return;
-        }
+        this->writer->push_frame((int32_t *)&sample);
     }
     else
     {
@@ -677,6 +725,13 @@ Tx_stream_libsnd_file::Tx_stream_libsnd_file(I2s_verif *i2s, pi_testbench_i2s_ve
     this->pending_channels = 0;
     this->items = new int32_t[channels];
     memset(this->items, 0, sizeof(uint32_t)*this->sfinfo.channels);
+
+    SNDFILE *sndfile = this->sndfile;
+    this->writer = new Audio_buffered_writer(channels,
+        [sndfile](const int32_t *frames, int64_t nb_frames) {
+            sf_writef_int(sndfile, (const int *)frames, nb_frames);
+        },
+        audio_buffer_block_frames(i2s->top), audio_buffer_nb_blocks(i2s->top));
 #else
 
     this->i2s->top->trace.fatal("Unable to open file (%s), libsndfile support is not active\n", filepath.c_str());
@@ -691,8 +746,10 @@ Tx_stream_libsnd_file::~Tx_stream_libsnd_file()
 #ifdef USE_SNDFILE
     if (this->pending_channels)
     {
-        sf_writef_int(this->sndfile, (const int *)this->items, 1);
+        this->writer->push_frame(this->items);
     }
+    // Make sure all frames are written before closing the file
+    delete this->writer;
     sf_close(this->sndfile);
 #endif
 }
@@ -703,7 +760,7 @@ void Tx_stream_libsnd_file::push_sample(uint32_t data, int channel)
 #ifdef USE_SNDFILE
     if (((this->pending_channels >> channel) & 1) == 1)
     {
-        sf_writef_int(this->sndfile, (const int *)this->items, 1);
+        this->writer->push_frame(this->items);
         this->pending_channels = 0;
         memset(this->items, 0, sizeof(uint32_t)*this->sfinfo.channels);
     }
@@ -725,24 +782,49 @@ Rx_stream_raw_file::Rx_stream_raw_file(Slot *slot, std::string filepath, int wid
     if (this->infile == NULL)
     {
          this->slot->top->trace.fatal("Unable to open input file (file: %s, error: %s)\n", filepath.c_str(), strerror(errno));
+         return;
+    }
+
+    if (this->is_bin)
+    {
+        int nb_bytes = (this->width + 7) / 8;
+        FILE *infile = this->infile;
+        this->reader = new Audio_buffered_reader(1,
+            [infile, nb_bytes](int32_t *frames, int64_t nb_frames) {
+                int64_t i;
+                for (i=0; i<nb_frames; i++)
+                {
+                    uint32_t sample = 0;
+                    if (fread((void *)&sample, nb_bytes, 1, infile) != 1)
+                    {
+                        break;
+                    }
+                    frames[i] = sample;
+                }
+                return i;
+            },
+            audio_buffer_block_frames(slot->top), audio_buffer_nb_blocks(slot->top));
     }
 }
 
 
-uint32_t Rx_stream_raw_file::get_sample(int channel_id)
+Rx_stream_raw_file::~Rx_stream_raw_file()
 {
-    if (this->is_bin)
+    delete this->reader;
+    if (this->infile)
     {
-        int nb_bytes = (this->width + 7) / 8;
-        uint32_t result = 0;
-        int freadres = fread((void *)&result, nb_bytes, 1, this->infile);
+        fclose(this->infile);
+    }
+}
 
-        // this->slot->top->trace.msg(vp::Trace::LEVEL_TRACE, "channel_id=%d, nb_bytes=%d, freadres=%d, result=%d\n", channel_id, nb_bytes, freadres, result);
 
-        if (freadres != 1)
-        {
-            return 0;
-        }
+uint32_t Rx_stream_raw_file::get_sample(int channel_id)
+{
+    if (this->is_bin)
+    {
+        // Once the end of file is reached, the reader returns 0, which is also what the encoding
+        // conversion gives
+        uint32_t result = *this->reader->get_frame();
 
         if (this->encoding == PI_TESTBENCH_I2S_VERIF_FILE_ENCODING_TYPE_PLUSMINUS)
         {
@@ -801,7 +883,12 @@ Rx_stream_libsnd_file::Rx_stream_libsnd_file(I2s_verif *i2s, pi_testbench_i2s_ve
     this->last_data_time = -1;
     this->next_data_time = -1;
 
-    this->items = new int32_t[nb_channels];
+    SNDFILE *sndfile = this->sndfile;
+    this->reader = new Audio_buffered_reader(this->sfinfo.channels,
+        [sndfile](int32_t *frames, int64_t nb_frames) {
+            return (int64_t)sf_readf_int(sndfile, frames, nb_frames);
+        },
+        audio_buffer_block_frames(i2s->top), audio_buffer_nb_blocks(i2s->top));
 #else
 
     this->i2s->top->trace.fatal("Unable to open file (%s), libsndfile support is not active\n", filepath.c_str());
@@ -810,13 +897,24 @@ Rx_stream_libsnd_file::Rx_stream_libsnd_file(I2s_verif *i2s, pi_testbench_i2s_ve
 #endif
 }
 
+Rx_stream_libsnd_file::~Rx_stream_libsnd_file()
+{
+#ifdef USE_SNDFILE
+    delete this->reader;
+    if (this->sndfile)
+    {
+        sf_close(this->sndfile);
+    }
+#endif
+}
+
 uint32_t Rx_stream_libsnd_file::get_sample(int channel)
 {
 #ifdef USE_SNDFILE
 
     if (((this->pending_channels >> channel) & 1) == 0)
     {
-        sf_readf_int(this->sndfile, this->items, 1);
+        this->items = this->reader->get_frame();
         this->pending_channels = (1 << this->sfinfo.channels) - 1;
     }
 
@@ -1055,6 +1153,22 @@ void Slot::stop(pi_testbench_i2s_verif_slot_stop_config_t *config)
 }
 
 
+void Slot::stop()
+{
+    // TX streams buffer frames and only write all of them when they are deleted, make sure this
+    // also happens if the simulation ends without stopping the slot
+    if (this->outstream)
+    {
+        this->outstream->use_count--;
+        if (this->outstream->use_count == 0)
+        {
+            delete this->outstream;
+        }
+        this->outstream = NULL;
+    }
+}
+
+
 void Slot::start_frame()
 {
     this->trace.msg(vp::Trace::LEVEL_DEBUG, "Start frame\n");
@@ -1323,9 +1437,7 @@ int64_t Slot::exec()
             }
             if (got_pcm_data)
             {
-                data = (int)this->pcm2pdm->pdm_output[cmpt++];
-                // pdm data must be 0/1
-                data = (data <= 0) ? 0 : 1;
+                data = this->pcm2pdm->get_pdm_bit(cmpt++);
             }
             else
             {
@@ -228,6 +228,8 @@ Testbench::Testbench(vp::ComponentConf &config)
 {
     this->state = STATE_WAITING_CMD;
     this->current_req_size = 0;
+    this->tx_buff_size = 0;
+    this->tx_buff_index = 0;
     this->is_pdm = false;
     traces.new_trace("trace", &trace, vp::DEBUG);
 
@@ -285,7 +287,65 @@ Testbench::Testbench(vp::ComponentConf &config)
         this->uarts[uart_id]->set_dev(new Uart_reply(this, this->uarts[uart_id]));
         this->uart_ctrl = this->uarts[uart_id];
     }
+    else
+    {
+        this->uart_ctrl = NULL;
+
+        if (this->ctrl_type == "io")
+        {
+            this->ctrl_itf.set_req_meth(&Testbench::ctrl_req);
+            this->new_slave_port("ctrl", &this->ctrl_itf);
+        }
+    }
+
+}
+
+
+vp::IoReqStatus Testbench::ctrl_req(vp::Block *__this, vp::IoReq *req)
+{
+    Testbench *_this = (Testbench *)__this;
+    uint64_t offset = req->get_addr();
+    uint64_t size = req->get_size();
+    uint8_t *data = req->get_data();
+
+    _this->trace.msg(vp::Trace::LEVEL_TRACE, "Control request (offset: 0x%lx, size: 0x%lx, is_write: %d)\n",
+        offset, size, req->get_is_write());
+
+    if (offset == TESTBENCH_CTRL_DATA_OFFSET && size <= 4)
+    {
+        if (req->get_is_write())
+        {
+            for (uint64_t i=0; i<size; i++)
+            {
+                _this->handle_received_byte(data[i]);
+            }
+        }
+        else
+        {
+            for (uint64_t i=0; i<size; i++)
+            {
+                if (_this->tx_buff_index < _this->tx_buff_size)
+                {
+                    data[i] = _this->tx_buff[_this->tx_buff_index];
+                    _this->send_byte_done();
+                }
+                else
+                {
+                    data[i] = 0;
+                }
+            }
+        }
+        return vp::IO_REQ_OK;
+    }
+    else if (offset == TESTBENCH_CTRL_STATUS_OFFSET && size == 4 && !req->get_is_write())
+    {
+        *(uint32_t *)data = _this->tx_buff_size - _this->tx_buff_index;
+        return vp::IO_REQ_OK;
+    }
 
+    _this->trace.force_warning("Invalid control access (offset: 0x%lx, size: 0x%lx, is_write: %d)\n",
+        offset, size, req->get_is_write());
+    return vp::IO_REQ_INVALID;
 }
 
 
@@ -725,13 +785,27 @@ void Testbench::send_byte_done()
         this->state = STATE_WAITING_CMD;
         this->current_req_size = 0;
     }
-    else
+    else if (this->uart_ctrl)
     {
         this->uart_ctrl->send_byte(this->tx_buff[this->tx_buff_index]);
     }
 }
 
 
+void Testbench::send_reply(uint8_t *buff, int size)
+{
+    this->tx_buff = buff;
+    this->tx_buff_size = size;
+    this->tx_buff_index = 0;
+
+    // With the memory-mapped channel, the reply stays there until the firmware reads it
+    if (this->uart_ctrl)
+    {
+        this->uart_ctrl->send_byte(this->tx_buff[0]);
+    }
+}
+
+
 void Testbench::handle_received_byte(uint8_t byte)
 {
     if (this->state == STATE_WAITING_CMD)
@@ -766,6 +840,8 @@ void Testbench::handle_received_byte(uint8_t byte)
                 this->state = STATE_WAITING_REQUEST;
                 this->req_size = cmd >> 16;
                 this->current_req_size = 0;
+                // Fields not sent by older firmwares are seen as 0
+                memset(this->req, 0, sizeof(this->req));
                 if (this->req_size == 0)
                 {
                     this->trace.fatal("Received zero size\n");
@@ -774,14 +850,17 @@ void Testbench::handle_received_byte(uint8_t byte)
 
 
             case PI_TESTBENCH_CMD_GET_TIME_PS:
+            {
+                uint8_t *reply = new uint8_t[8];
+                *(uint64_t *)reply = this->time.get_time();
+                if (this->uart_ctrl)
+                {
+                    this->uart_ctrl->itf.sync_full(1, 2, 0, 0xf);
+                }
                 this->state = STATE_SENDING_REPLY;
-                this->tx_buff = new uint8_t[8];
-                *(uint64_t *)this->tx_buff = this->time.get_time();
-                this->tx_buff_size = 8;
-                this->tx_buff_index = 0;
-                this->uart_ctrl->itf.sync_full(1, 2, 0, 0xf);
-                this->uart_ctrl->send_byte(this->tx_buff[0]);
+                this->send_reply(reply, 8);
                 break;
+            }
 
             default:
                 this->trace.fatal("Received unknown request: 0x%2.2x\n", this->cmd & 0xffff);
@@ -910,27 +989,23 @@ void Testbench::gpio_sync(vp::Block *__this, int value, int id)
     {
         if (value == 1)
         {
-            if (gpio->get_frequency_current_period)
+            gpio->get_frequency_start = _this->time.get_time();
+            if (gpio->get_frequency_current_period == 0)
             {
-                gpio->get_frequency_period += _this->time.get_time() - gpio->get_frequency_start;
+                gpio->get_frequency_first = gpio->get_frequency_start;
             }
-
-            gpio->get_frequency_start = _this->time.get_time();
             gpio->get_frequency_current_period++;
 
             if (gpio->get_frequency_current_period == gpio->get_frequency_nb_period + 1)
             {
+                // Average period from the first and last rising edges
                 pi_testbench_req_gpio_get_frequency_reply_t *reply = new pi_testbench_req_gpio_get_frequency_reply_t;
-                reply->period = gpio->get_frequency_period / gpio->get_frequency_nb_period;
+                reply->period = (gpio->get_frequency_start - gpio->get_frequency_first) / gpio->get_frequency_nb_period;
                 reply->width = gpio->get_frequency_width / gpio->get_frequency_nb_period;
 
                 _this->trace.msg(vp::Trace::LEVEL_INFO, "Finished sampling frequency (gpio: %d, period: %ld, width: %ld)\n", id, reply->period, reply->width);
 
-                _this->tx_buff = (uint8_t *)reply;
-                _this->tx_buff_size = sizeof(pi_testbench_req_gpio_get_frequency_reply_t);
-                _this->tx_buff_index = 0;
-
-                _this->uart_ctrl->send_byte(_this->tx_buff[0]);
+                _this->send_reply((uint8_t *)reply, sizeof(pi_testbench_req_gpio_get_frequency_reply_t));
 
                 gpio->get_frequency = false;
             }
@@ -1138,7 +1213,7 @@ void Testbench::handle_gpio_get_frequency()
     {
         gpio->get_frequency_current_period = 0;
         gpio->get_frequency_nb_period = req->gpio_get_frequency.nb_period;
-        gpio->get_frequency_period = 0;
+        gpio->get_frequency_first = -1;
         gpio->get_frequency_width = 0;
         gpio->get_frequency_start = -1;
     }
@@ -1153,21 +1228,19 @@ void Testbench::handle_gpio_pulse_gen()
     int gpio_id = req->gpio_pulse_gen.gpio;
     int64_t duration_ps = req->gpio_pulse_gen.duration_ps;
     int64_t period_ps = req->gpio_pulse_gen.period_ps;
+    int64_t nb_pulses = req->gpio_pulse_gen.nb_pulses;
     Gpio *gpio = this->gpios[gpio_id];
     
-    this->trace.msg(vp::Trace::LEVEL_INFO, "Handling GPIO pulse generator (gpio: %d, enabled: %d, duration_ps: %ld, period_ps: %ld)\n",
-        gpio_id, enabled, duration_ps, period_ps);
+    this->trace.msg(vp::Trace::LEVEL_INFO, "Handling GPIO pulse generator (gpio: %d, enabled: %d, duration_ps: %ld, period_ps: %ld, nb_pulses: %ld)\n",
+        gpio_id, enabled, duration_ps, period_ps, nb_pulses);
 
-    gpio->pulse_enabled = enabled;
+    gpio->pulse_stop();
 
     gpio->itf.sync(0);
 
     if (enabled)
     {
-        gpio->pulse_duration_ps = duration_ps;
-        gpio->pulse_period_ps = period_ps;
-        gpio->pulse_gen_rising_edge = true;
-        this->event_enqueue(gpio->pulse_event, req->gpio_pulse_gen.first_delay_ps);
+        gpio->pulse_start(req->gpio_pulse_gen.first_delay_ps, duration_ps, period_ps, nb_pulses);
     }
 }
 
@@ -1791,28 +1864,58 @@ std::string Testbench::handle_command(gv::GvProxy *proxy, FILE *req_file, FILE *
 }
 
 
-void Gpio::pulse_handler(vp::Block *__this, vp::ClockEvent *event)
+void Gpio::pulse_start(int64_t first_delay_ps, int64_t duration_ps, int64_t period_ps,
+    int64_t nb_pulses)
+{
+    this->pulse_enabled = true;
+    this->pulse_duration_ps = duration_ps;
+    this->pulse_period_ps = period_ps;
+    this->pulse_nb_pulses = nb_pulses;
+    this->pulse_gen_rising_edge = true;
+    this->pulse_event->enqueue(first_delay_ps);
+}
+
+
+void Gpio::pulse_stop()
 {
-    Gpio *_this = (Gpio *)__this;
+    this->pulse_enabled = false;
+    if (this->pulse_event->is_enqueued())
+    {
+        this->pulse_event->cancel();
+    }
+}
+
+
+void Gpio::pulse_handler(vp::Block *__this, vp::TimeEvent *event)
+{
+    Gpio *_this = (Gpio *)event->get_args()[0];
 
     _this->itf.sync(_this->pulse_gen_rising_edge);
 
     if (_this->pulse_gen_rising_edge)
     {
-        _this->top->event_enqueue(_this->pulse_event, _this->pulse_duration_ps);
+        _this->pulse_event->enqueue(_this->pulse_duration_ps);
     }
-    else if (_this->pulse_period_ps > 0)
+    else if (_this->pulse_period_ps > 0 && _this->pulse_nb_pulses != 1)
     {
-        _this->top->event_enqueue(_this->pulse_event, _this->pulse_period_ps - _this->pulse_duration_ps);
+        // A count of 0 means infinite, and is left as is
+        if (_this->pulse_nb_pulses > 1)
+        {
+            _this->pulse_nb_pulses--;
+        }
+        _this->pulse_event->enqueue(_this->pulse_period_ps - _this->pulse_duration_ps);
     }
-    
+
     _this->pulse_gen_rising_edge ^= 1;
 }
 
 
 Gpio::Gpio(Testbench *top) : top(top)
 {
-    this->pulse_event = top->event_new((vp::Block *)this, Gpio::pulse_handler);
+    // Time event so that the delays of the request are really in picoseconds, a clock event
+    // would count them in testbench clock cycles
+    this->pulse_event = new vp::TimeEvent(top, &Gpio::pulse_handler);
+    this->pulse_event->get_args()[0] = this;
     this->get_frequency = false;
 }
 
@@ -96,6 +96,11 @@ typedef struct {
     int64_t period_ps;
     uint8_t gpio;
     uint8_t enabled;
+    // Covers the padding of the original request, which may contain garbage
+    uint8_t reserved[6];
+    // Number of pulses to generate, 0 means infinite. This is after the original request, so
+    // that it is seen as 0 when an older firmware does not send it.
+    uint32_t nb_pulses;
 } pi_testbench_req_gpio_pulse_gen_t;
 
 
@@ -326,6 +331,14 @@ typedef struct
 __attribute__((packed)) pi_testbench_i2s_verif_slot_stop_config_t;
 
 
+// Registers of the memory-mapped control channel, used when ctrl_type is "io".
+// Bytes written to DATA are handled as if they were received from the control UART, from the
+// lowest to the highest address, and reads of DATA return the bytes of the pending reply.
+// STATUS gives the number of reply bytes which can be read.
+#define TESTBENCH_CTRL_DATA_OFFSET   0x0
+#define TESTBENCH_CTRL_STATUS_OFFSET 0x4
+
+
 typedef enum {
     STATE_WAITING_CMD,
     STATE_WAITING_REQUEST,
@@ -337,7 +350,12 @@ class Gpio
 {
 public:
     Gpio(Testbench *top);
-    static void pulse_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void pulse_handler(vp::Block *__this, vp::TimeEvent *event);
+
+    // Start generating pulses, nb_pulses is 0 to generate them until the generator is stopped
+    void pulse_start(int64_t first_delay_ps, int64_t duration_ps, int64_t period_ps,
+        int64_t nb_pulses);
+    void pulse_stop();
 
     Testbench *top;
 
@@ -347,17 +365,20 @@ public:
     uint32_t value;
 
 
-    vp::ClockEvent *pulse_event;
+    vp::TimeEvent *pulse_event;
     int64_t pulse_duration_ps;
     int64_t pulse_period_ps;
+    // Number of pulses still to be generated, including the current one, or 0 if infinite
+    int64_t pulse_nb_pulses;
     bool pulse_enabled = false;
     bool pulse_gen_rising_edge = false;
     bool get_frequency;
     int64_t get_frequency_current_period;
     int64_t get_frequency_nb_period;
+    // Timestamps of the first and last rising edges of the measure
+    int64_t get_frequency_first;
     int64_t get_frequency_start;
     int64_t get_frequency_width;
-    int64_t get_frequency_period;
 };
 
 
@@ -633,6 +654,9 @@ public:
 
     void send_byte_done();
 
+    // Send a reply to the firmware through the control channel
+    void send_reply(uint8_t *buff, int size);
+
     gv::GvProxy *proxy;
 
     vp::Trace trace;
@@ -668,11 +692,14 @@ private:
 
     static void gpio_sync(vp::Block *__this, int value, int id);
     static void i2c_sync(vp::Block *__this, int scl, int sda, int id);
+    static vp::IoReqStatus ctrl_req(vp::Block *__this, vp::IoReq *req);
 
     string ctrl_type;
     uint64_t period;
 
     vp::UartSlave uart_in;
+    // Memory-mapped control channel
+    vp::IoSlave ctrl_itf;
 
     testbench_state_e state;
 
@@ -33,13 +33,23 @@ class Testbench(st.Component):
     i2s : list
         List of I2S interfaces which must be connected to the testbench
 
+    ctrl_type : str
+        How the simulated SW sends commands to the testbench. 'uart' uses the control UART,
+        sampled bit by bit, while 'io' uses a memory-mapped channel through the 'ctrl' port, with
+        the same protocol but one access per byte or word.
+
     """
 
-    def __init__(self, parent, name, uart=[], i2s=[], nb_gpio=0, spislave_dummy_cycles=0):
+    def __init__(self, parent, name, uart=[], i2s=[], nb_gpio=0, spislave_dummy_cycles=0,
+            ctrl_type='uart'):
         super(Testbench, self).__init__(parent, name)
 
         # Testbench implementation as this component is just a wrapper
-        testbench = Testbench.Testbench_implem(self, 'testbench', nb_gpio=nb_gpio, spislave_dummy_cycles=spislave_dummy_cycles)
+        testbench = Testbench.Testbench_implem(self, 'testbench', nb_gpio=nb_gpio,
+            spislave_dummy_cycles=spislave_dummy_cycles, ctrl_type=ctrl_type)
+
+        if ctrl_type == 'io':
+            self.bind(self, 'ctrl', testbench, 'ctrl')
 
         # The testbench needs its owm cloc domain to enqueue clock events
         clock = Clock_domain(self, 'clock', frequency=50000000)
@@ -78,7 +88,8 @@ class Testbench(st.Component):
 
     class Testbench_implem(st.Component):
 
-        def __init__(self, parent, name, uart_id=0, uart_baudrate=115200, nb_gpio=0, spislave_dummy_cycles=0):
+        def __init__(self, parent, name, uart_id=0, uart_baudrate=115200, nb_gpio=0, spislave_dummy_cycles=0,
+                ctrl_type='uart'):
             super(Testbench.Testbench_implem, self).__init__(parent, name)
 
             # Register all parameters as properties so that they can be overwritten from the command-line
@@ -89,7 +100,7 @@ class Testbench(st.Component):
             
             self.add_properties({
                 "verbose": False,
-                "ctrl_type": "uart",
+                "ctrl_type": ctrl_type,
                 "nb_gpio": nb_gpio,
                 "nb_spi": 7,
                 "nb_uart": 5,
@@ -98,6 +109,13 @@ class Testbench(st.Component):
                 "uart_id": self.get_property('uart_id'),
                 "uart_baudrate": self.get_property('uart_baudrate'),
 
+                # Buffering of I2S audio files, which are read ahead and written behind by
+                # blocks from a helper thread. 0 selects the default.
+                "audio_buffer": {
+                    "block_frames": 0,
+                    "nb_blocks": 0
+                },
+
                 "spislave_boot": {
                     "enabled": False,
                     "delay_ps": "1000000000",
@@ -28,11 +28,13 @@
 #include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
 
 #include <sys/time.h>
 #include <stdint.h>
 #include <vp/vp.hpp>
-#include <queue>
 #include <vp/itf/io.hpp>
 #include <thread>
 
@@ -119,11 +121,31 @@ private:
     int read(bool blocking=false);
     void write(char ch);
     void stdin_task();
+    void backend_open();
+    static void tx_handler(vp::Block *__this, vp::TimeEvent *event);
+    int64_t get_byte_time();
+    inline void rx_push(uint8_t value);
+    inline uint8_t rx_pop();
 
     vp::Trace trace;
     uint32_t reg_shift;
     uint32_t reg_io_width;
-    std::queue<uint8_t> rx_queue;
+    // RX FIFO, as a ring buffer
+    uint8_t rx_fifo[UART_QUEUE_SIZE];
+    int rx_head;
+    int rx_count;
+    // TX FIFO, only used when bytes are paced at the baud rate
+    uint8_t tx_fifo[UART_QUEUE_SIZE];
+    int tx_head;
+    int tx_count;
+    // True while a byte is being sent by the shift register
+    bool tx_shifting;
+    uint8_t tx_shift_byte;
+    vp::TimeEvent tx_event;
+    // Frequency of the UART input clock, or 0 to send bytes without any delay
+    int64_t clock_frequency;
+    // Current level of the interrupt line, only modifications are propagated
+    bool irq_level;
     uint8_t dll;
     uint8_t dlm;
     uint8_t iir;
@@ -143,6 +165,9 @@ private:
 
     struct termios old_tios;
     bool restore_tios;
+    // Host side of the UART. Input is -1 when nothing can be received.
+    int in_fd;
+    int out_fd;
 
     std::thread *stdin_thread;
 };
@@ -153,13 +178,90 @@ private:
 void Ns16550::stop()
 {
     if (restore_tios)
-        tcsetattr(0, TCSANOW, &old_tios);
+        tcsetattr(this->in_fd, TCSANOW, &old_tios);
+}
+
+
+inline void Ns16550::rx_push(uint8_t value)
+{
+    this->rx_fifo[(this->rx_head + this->rx_count) % UART_QUEUE_SIZE] = value;
+    this->rx_count++;
+}
+
+
+inline uint8_t Ns16550::rx_pop()
+{
+    uint8_t value = this->rx_fifo[this->rx_head];
+    this->rx_head = (this->rx_head + 1) % UART_QUEUE_SIZE;
+    this->rx_count--;
+    return value;
+}
+
+
+int64_t Ns16550::get_byte_time()
+{
+    // Start bit, data bits, optional parity bit and stop bits, each bit taking 16 cycles of the
+    // input clock divided by the divisor latch
+    int nb_bits = 1 + 5 + (lcr & 3) + ((lcr & UART_LCR_PARITY) ? 1 : 0) + ((lcr & UART_LCR_STOP) ? 2 : 1);
+    int divisor = (this->dlm << 8) | this->dll;
+    if (divisor == 0)
+    {
+        divisor = 1;
+    }
+    // The product in picoseconds exceeds 64 bits for the biggest divisors, 128 bits are used
+    // so that the result stays exact
+    return (int64_t)((__int128)nb_bits * 16 * divisor * 1000000000000LL / this->clock_frequency);
+}
+
+
+void Ns16550::tx_handler(vp::Block *__this, vp::TimeEvent *event)
+{
+    Ns16550 *_this = (Ns16550 *)__this;
+
+    _this->write(_this->tx_shift_byte);
+
+    if (_this->tx_count)
+    {
+        _this->tx_shift_byte = _this->tx_fifo[_this->tx_head];
+        _this->tx_head = (_this->tx_head + 1) % UART_QUEUE_SIZE;
+        _this->tx_count--;
+        _this->tx_event.enqueue(_this->get_byte_time());
+    }
+    else
+    {
+        _this->tx_shifting = false;
+    }
+
+    if (_this->tx_count == 0)
+    {
+        _this->lsr |= UART_LSR_THRE;
+        if (!_this->tx_shifting)
+        {
+            _this->lsr |= UART_LSR_TEMT;
+        }
+    }
+
+    _this->update_interrupt();
 }
 
 
 
 void Ns16550::reset(bool active)
 {
+    if (active)
+    {
+        if (this->tx_event.is_enqueued())
+        {
+            this->tx_event.cancel();
+        }
+
+        this->rx_head = 0;
+        this->rx_count = 0;
+        this->tx_head = 0;
+        this->tx_count = 0;
+        this->tx_shifting = false;
+        this->lsr = UART_LSR_TEMT | UART_LSR_THRE;
+    }
 }
 
 vp::IoReqStatus Ns16550::req(vp::Block *__this, vp::IoReq *req)
@@ -187,53 +289,32 @@ void Ns16550::update_interrupt(void)
 {
     uint8_t interrupts = 0;
 
-    /* Handle clear rx */
-    if (lcr & UART_FCR_CLEAR_RCVR)
-    {
-        lcr &= ~UART_FCR_CLEAR_RCVR;
-        while (!rx_queue.empty())
-        {
-            rx_queue.pop();
-        }
-        lsr &= ~UART_LSR_DR;
-    }
-
-    /* Handle clear tx */
-    if (lcr & UART_FCR_CLEAR_XMIT)
-    {
-        lcr &= ~UART_FCR_CLEAR_XMIT;
-        lsr |= UART_LSR_TEMT | UART_LSR_THRE;
-    }
-
     /* Data ready and rcv interrupt enabled ? */
     if ((ier & UART_IER_RDI) && (lsr & UART_LSR_DR))
     {
         interrupts |= UART_IIR_RDI;
     }
 
-    /* Transmitter empty and interrupt enabled ? */
-    if ((ier & UART_IER_THRI) && (lsr & UART_LSR_TEMT))
+    /* Transmitter holding register empty and interrupt enabled ? */
+    if ((ier & UART_IER_THRI) && (lsr & UART_LSR_THRE))
     {
         interrupts |= UART_IIR_THRI;
     }
 
     /* Now update the interrup line, if necessary */
-    if (!interrupts)
-    {
-        iir = UART_IIR_NO_INT;
-        this->irq_itf.sync(false);
-    }
-    else
+    iir = interrupts ? interrupts : UART_IIR_NO_INT;
+    if ((interrupts != 0) != this->irq_level)
     {
-        iir = interrupts;
-        this->irq_itf.sync(true);
+        this->irq_level = interrupts != 0;
+        this->irq_itf.sync(this->irq_level);
     }
 
     /*
      * If the OS disabled the tx interrupt, we know that there is nothing
-     * more to transmit.
+     * more to transmit. This does not apply when bytes are paced, since they are still
+     * in the FIFO.
      */
-    if (!(ier & UART_IER_THRI))
+    if (!(ier & UART_IER_THRI) && this->clock_frequency == 0)
     {
         lsr |= UART_LSR_TEMT | UART_LSR_THRE;
     }
@@ -241,7 +322,7 @@ void Ns16550::update_interrupt(void)
 
 uint8_t Ns16550::rx_byte(void)
 {
-    if (rx_queue.empty())
+    if (rx_count == 0)
     {
         lsr &= ~UART_LSR_DR;
         return 0;
@@ -254,9 +335,8 @@ uint8_t Ns16550::rx_byte(void)
         return 0;
     }
 
-    uint8_t ret = rx_queue.front();
-    rx_queue.pop();
-    if (rx_queue.empty())
+    uint8_t ret = rx_pop();
+    if (rx_count == 0)
     {
         lsr &= ~UART_LSR_DR;
     }
@@ -266,8 +346,38 @@ uint8_t Ns16550::rx_byte(void)
 
 void Ns16550::tx_byte(uint8_t val)
 {
-    lsr |= UART_LSR_TEMT | UART_LSR_THRE;
-    this->write(val);
+    if (this->clock_frequency == 0)
+    {
+        lsr |= UART_LSR_TEMT | UART_LSR_THRE;
+        this->write(val);
+        return;
+    }
+
+    // Without FIFO, only the holding register can be used
+    int fifo_size = (fcr & UART_FCR_ENABLE_FIFO) ? UART_QUEUE_SIZE : 1;
+
+    if (!this->tx_shifting)
+    {
+        this->tx_shifting = true;
+        this->tx_shift_byte = val;
+        this->tx_event.enqueue(this->get_byte_time());
+    }
+    else if (this->tx_count < fifo_size)
+    {
+        this->tx_fifo[(this->tx_head + this->tx_count) % UART_QUEUE_SIZE] = val;
+        this->tx_count++;
+    }
+    else
+    {
+        // The software did not wait for the FIFO to have space, the byte is lost
+        this->trace.msg(vp::Trace::LEVEL_WARNING, "TX FIFO overflow, dropping byte (value: 0x%x)\n", val);
+    }
+
+    lsr &= ~UART_LSR_TEMT;
+    if (this->tx_count != 0)
+    {
+        lsr &= ~UART_LSR_THRE;
+    }
 }
 
 
@@ -367,9 +477,9 @@ bool Ns16550::store(unsigned int addr, size_t len, const uint8_t *bytes)
         /* Loopback mode */
         if (mcr & UART_MCR_LOOP)
         {
-            if (rx_queue.size() < UART_QUEUE_SIZE)
+            if (rx_count < UART_QUEUE_SIZE)
             {
-                rx_queue.push(val);
+                rx_push(val);
                 lsr |= UART_LSR_DR;
             }
             break;
@@ -389,7 +499,24 @@ bool Ns16550::store(unsigned int addr, size_t len, const uint8_t *bytes)
         update = true;
         break;
     case UART_FCR:
-        fcr = val;
+        /* The clear bits are self-clearing and only act on the FIFOs */
+        fcr = val & ~(UART_FCR_CLEAR_RCVR | UART_FCR_CLEAR_XMIT);
+
+        if (val & UART_FCR_CLEAR_RCVR)
+        {
+            rx_count = 0;
+            lsr &= ~UART_LSR_DR;
+        }
+
+        if (val & UART_FCR_CLEAR_XMIT)
+        {
+            tx_count = 0;
+            lsr |= UART_LSR_THRE;
+            if (!tx_shifting)
+            {
+                lsr |= UART_LSR_TEMT;
+            }
+        }
         update = true;
         break;
     case UART_LCR:
@@ -434,14 +561,14 @@ void Ns16550::stdin_task(void)
 
         while (!(this->fcr & UART_FCR_ENABLE_FIFO) ||
             (this->mcr & UART_MCR_LOOP) ||
-            (UART_QUEUE_SIZE <= this->rx_queue.size()))
+            (UART_QUEUE_SIZE <= this->rx_count))
         {
             this->time.get_engine()->unlock();
             usleep(1000);
             this->time.get_engine()->lock();
         }
 
-        this->rx_queue.push((uint8_t)rc);
+        this->rx_push((uint8_t)rc);
         this->lsr |= UART_LSR_DR;
 
         this->update_interrupt();
@@ -454,26 +581,105 @@ void Ns16550::stdin_task(void)
 int Ns16550::read(bool blocking)
 {
   struct pollfd pfd;
-  pfd.fd = 0;
+  pfd.fd = this->in_fd;
   pfd.events = POLLIN;
       int ret = poll(&pfd, 1, blocking ? -1 : 0);
   if (ret <= 0 || !(pfd.revents & POLLIN))
     return -1;
 
   unsigned char ch;
-  ret = ::read(0, &ch, 1);
+  ret = ::read(this->in_fd, &ch, 1);
   return ret <= 0 ? -1 : ch;
 }
 
 
 void Ns16550::write(char ch)
 {
-  if (::write(1, &ch, 1) != 1)
-    abort();
+  if (::write(this->out_fd, &ch, 1) != 1)
+  {
+    // The pty is non-blocking so that the simulation does not hang if nobody is reading it
+    if (errno != EAGAIN)
+      abort();
+  }
+}
+
+
+void Ns16550::backend_open()
+{
+    std::string backend = this->get_js_config()->get_child_str("backend");
+
+    this->restore_tios = false;
+
+    if (backend == "pty")
+    {
+        int fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0)
+        {
+            this->trace.fatal("Unable to open pty: %s\n", strerror(errno));
+            return;
+        }
+
+        struct termios tios;
+        if (tcgetattr(fd, &tios) == 0)
+        {
+            cfmakeraw(&tios);
+            tcsetattr(fd, TCSANOW, &tios);
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        // Keep the slave side open, otherwise the master is hung up until a terminal connects,
+        // which would stop the input thread
+        if (open(ptsname(fd), O_RDWR | O_NOCTTY) < 0)
+        {
+            this->trace.fatal("Unable to open pty slave: %s\n", strerror(errno));
+            return;
+        }
+
+        printf("UART %s is available on %s\n", this->get_path().c_str(), ptsname(fd));
+
+        this->in_fd = fd;
+        this->out_fd = fd;
+    }
+    else if (backend == "file")
+    {
+        std::string tx_file = this->get_js_config()->get_child_str("tx_file");
+        std::string rx_file = this->get_js_config()->get_child_str("rx_file");
+
+        this->out_fd = open(tx_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (this->out_fd < 0)
+        {
+            this->trace.fatal("Unable to open TX file (path: %s): %s\n", tx_file.c_str(), strerror(errno));
+            return;
+        }
+
+        this->in_fd = -1;
+        if (rx_file != "")
+        {
+            this->in_fd = open(rx_file.c_str(), O_RDONLY);
+            if (this->in_fd < 0)
+            {
+                this->trace.fatal("Unable to open RX file (path: %s): %s\n", rx_file.c_str(), strerror(errno));
+                return;
+            }
+        }
+    }
+    else
+    {
+        this->in_fd = 0;
+        this->out_fd = 1;
+
+        if (tcgetattr(0, &old_tios) == 0)
+        {
+            struct termios new_tios = old_tios;
+            new_tios.c_lflag &= ~(ICANON | ECHO);
+            if (tcsetattr(0, TCSANOW, &new_tios) == 0)
+                restore_tios = true;
+        }
+    }
 }
 
 Ns16550::Ns16550(vp::ComponentConf &config)
-    : vp::Component(config)
+    : vp::Component(config), tx_event(this, &Ns16550::tx_handler)
 {
     this->traces.new_trace("trace", &this->trace, vp::DEBUG);
 
@@ -484,27 +690,33 @@ Ns16550::Ns16550(vp::ComponentConf &config)
     lsr = UART_LSR_TEMT | UART_LSR_THRE;
     msr = UART_MSR_DCD | UART_MSR_DSR | UART_MSR_CTS;
     dll = 0x0C;
+    dlm = 0;
     mcr = UART_MCR_OUT2;
     scr = 0;
 
     reg_io_width = 1;
 
+    rx_head = 0;
+    rx_count = 0;
+    tx_head = 0;
+    tx_count = 0;
+    tx_shifting = false;
+    irq_level = false;
+    clock_frequency = this->get_js_config()->get_child_int("clock_frequency");
+
     this->input_itf.set_req_meth(&Ns16550::req);
     new_slave_port("input", &this->input_itf);
 
     this->new_master_port("irq", &this->irq_itf);
 
-    this->restore_tios = false;
-    if (tcgetattr(0, &old_tios) == 0)
+    this->backend_open();
+
+    this->stdin_thread = NULL;
+    if (this->in_fd >= 0)
     {
-        struct termios new_tios = old_tios;
-        new_tios.c_lflag &= ~(ICANON | ECHO);
-        if (tcsetattr(0, TCSANOW, &new_tios) == 0)
-            restore_tios = true;
+        this->stdin_thread = new std::thread(&Ns16550::stdin_task, this);
     }
 
-    this->stdin_thread = new std::thread(&Ns16550::stdin_task, this);
-
 }
 
 
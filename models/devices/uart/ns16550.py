@@ -18,12 +18,41 @@ import gvsoc.systree
 
 class Ns16550(gvsoc.systree.Component):
 
-    def __init__(self, parent, name):
+    """NS16550 UART
+
+    Attributes
+    ----------
+    parent: gvsoc.systree.Component
+        The parent component where this one should be instantiated.
+    name: str
+        The name of the component within the parent space.
+    clock_frequency: int
+        Frequency of the UART input clock. If it is not 0, transmitted bytes are paced at the baud
+        rate given by the divisor latch, otherwise they are sent immediately.
+    backend: str
+        Where bytes are sent and received, can be 'stdio' for the terminal, 'pty' for a
+        pseudo-terminal whose path is printed at startup, or 'file'.
+    tx_file: str
+        Path of the file where transmitted bytes are written, with the 'file' backend.
+    rx_file: str
+        Path of the file where received bytes are read, with the 'file' backend, or None to not
+        receive anything.
+    """
+
+    def __init__(self, parent, name, clock_frequency: int=0, backend: str='stdio',
+            tx_file: str='uart_tx', rx_file: str=None):
 
         super(Ns16550, self).__init__(parent, name)
 
         self.set_component('devices.uart.ns16550')
 
+        self.add_properties({
+            'clock_frequency': clock_frequency,
+            'backend': backend,
+            'tx_file': tx_file,
+            'rx_file': rx_file if rx_file is not None else '',
+        })
+
     def i_INPUT(self) -> gvsoc.systree.SlaveItf:
         return gvsoc.systree.SlaveItf(self, 'input', signature='io')
 
@@ -48,12 +48,11 @@ Gdb_server::Gdb_server(vp::ComponentConf &conf)
 
 int Gdb_server::register_core(vp::Gdbserver_core *core)
 {
-    int id = this->current_id++;
+    int id = this->cores_list.size();
     core->gdbserver_set_id(id);
 
     this->trace.msg(vp::Trace::LEVEL_INFO, "Registering core (id: %d)\n", id);
 
-    this->cores[id] = core;
     this->cores_list.push_back(core);
 
     js::Config *config = this->get_js_config();
@@ -92,7 +91,7 @@ int Gdb_server::set_active_core(int id)
 {
     this->trace.msg(vp::Trace::LEVEL_DEBUG, "Setting active core (id: %d)\n", id);
 
-    if (this->cores[id] != NULL)
+    if (this->get_core(id) != NULL)
     {
         this->active_core = id;
         return 0;
@@ -105,7 +104,7 @@ int Gdb_server::set_active_core_for_other(int id)
 {
     this->trace.msg(vp::Trace::LEVEL_DEBUG, "Setting active core for other (id: %d)\n", id);
 
-    if (this->cores[id] != NULL)
+    if (this->get_core(id) != NULL)
     {
         this->active_core_for_other = id;
         return 0;
@@ -121,7 +120,12 @@ vp::Gdbserver_core *Gdb_server::get_core(int id)
         id = this->active_core;
     }
 
-    return this->cores[id];
+    if (id < 0 || id >= (int)this->cores_list.size())
+    {
+        return NULL;
+    }
+
+    return this->cores_list[id];
 }
 
 vp::Gdbserver_core *Gdb_server::get_active_core()
@@ -143,33 +147,33 @@ int Gdb_server::io_access(uint64_t addr, int size, uint8_t *data, bool is_write)
 
 void Gdb_server::breakpoint_insert(uint64_t addr)
 {
-    for (auto x: this->cores)
+    for (vp::Gdbserver_core *core: this->cores_list)
     {
-        x.second->gdbserver_breakpoint_insert(addr);
+        core->gdbserver_breakpoint_insert(addr);
     }
 }
 
 void Gdb_server::breakpoint_remove(uint64_t addr)
 {
-    for (auto x: this->cores)
+    for (vp::Gdbserver_core *core: this->cores_list)
     {
-        x.second->gdbserver_breakpoint_remove(addr);
+        core->gdbserver_breakpoint_remove(addr);
     }
 }
 
 void Gdb_server::watchpoint_insert(bool is_write, uint64_t addr, int size)
 {
-    for (auto x: this->cores)
+    for (vp::Gdbserver_core *core: this->cores_list)
     {
-        x.second->gdbserver_watchpoint_insert(is_write, addr, size);
+        core->gdbserver_watchpoint_insert(is_write, addr, size);
     }
 }
 
 void Gdb_server::watchpoint_remove(bool is_write, uint64_t addr, int size)
 {
-    for (auto x: this->cores)
+    for (vp::Gdbserver_core *core: this->cores_list)
     {
-        x.second->gdbserver_watchpoint_remove(is_write, addr, size);
+        core->gdbserver_watchpoint_remove(is_write, addr, size);
     }
 }
 
@@ -66,9 +66,8 @@ public:
 
 
 private:
-    int current_id = 0;
     Rsp *rsp;
-    std::unordered_map<int, vp::Gdbserver_core *> cores;
+    // Registered cores, indexed by their id
     std::vector<vp::Gdbserver_core *> cores_list;
     int active_core;
     int active_core_for_other;
@@ -123,7 +123,7 @@ static void escape(const char *data, size_t len, char *raw, size_t *raw_idx, uin
     {
         char c = data[i];
         // check if escaping needed
-        if (c == '#' || c == '%' || c == '}' || c == '*')
+        if (c == '#' || c == '$' || c == '%' || c == '}' || c == '*')
         {
             if (seq_len > 0)
             {
@@ -237,7 +237,12 @@ bool RspPacketCodec::decoder(CircularCharBuffer *circ_buf)
             // case a packet is split on the } character
 
             start_idx = buf_idx;
-            bool hash_found = scan_for_hash(buf, &buf_idx, &m_escaped, buf_len);
+            size_t scan_len = buf_len;
+            if (scan_len - start_idx > RSP_PACKET_MAX_LEN - m_cur)
+            {
+                scan_len = start_idx + RSP_PACKET_MAX_LEN - m_cur;
+            }
+            bool hash_found = scan_for_hash(buf, &buf_idx, &m_escaped, scan_len);
             memcpy(&m_pkt[m_cur], &buf[start_idx], buf_idx - start_idx);
             m_cur += buf_idx - start_idx;
             if (hash_found)
@@ -272,7 +277,7 @@ bool RspPacketCodec::decoder(CircularCharBuffer *circ_buf)
                 circ_buf->commit_read(2);
                 m_pkt_len = deescape(m_pkt, m_cur);
                 // clear the rest of the buffer
-                memset(&(m_pkt[m_pkt_len]), 0, RSP_PACKET_MAX_LEN - m_pkt_len);
+                memset(&(m_pkt[m_pkt_len]), 0, RSP_PACKET_MAX_LEN + 1 - m_pkt_len);
                 //m_log.protocol("received packet: %s\n", m_pkt);
                 m_decode_state = STATE_INIT;
                 m_pkt_decoded(m_pkt, m_pkt_len);
@@ -33,7 +33,7 @@
 #include <memory>
 #include "circular-buffer.hpp"
 
-#define RSP_PACKET_MAX_LEN (16*1024u)
+#define RSP_PACKET_MAX_LEN (64*1024u)
 #define RSP_CTRLC_CHAR 0x03
 #define RSP_ACK_STR "+"
 #define RSP_ACK_CHAR '+'
@@ -80,12 +80,13 @@ public:
     bool encode(const char * buf, size_t len, CircularCharBuffer *circ_buf, bool dont_encode_runs);
     bool encode_ack(CircularCharBuffer *circ_buf);
 private:
-    char s_out_pkt[RSP_PACKET_MAX_LEN];
+    // Binary payloads can be fully escaped, which doubles their size
+    char s_out_pkt[RSP_PACKET_MAX_LEN * 2 + 4];
 
     bool decoder(CircularCharBuffer *circ_buf);
     
     RspPacketDecoderStates m_decode_state;
-    char m_pkt[RSP_PACKET_MAX_LEN];
+    char m_pkt[RSP_PACKET_MAX_LEN + 1];
     size_t m_cur, m_last, m_pkt_len, m_crc_start;
     bool m_escaped;
     PacketDecodedProc m_pkt_decoded;
@@ -25,7 +25,10 @@
 #include <netinet/in.h>
 #include <unistd.h>
 
-#define RSP_PACKET_MAX_SIZE (16*1024)
+#define RSP_PACKET_MAX_SIZE RSP_PACKET_MAX_LEN
+// Maximum number of bytes returned by a memory read, so that the reply fits the packet size
+// in both hexadecimal and escaped binary forms
+#define RSP_MEM_READ_MAX_SIZE ((RSP_PACKET_MAX_SIZE - 16) / 2)
 #define REPLY_BUF_LEN 256
 
 
@@ -57,7 +60,8 @@ void Rsp::proxy_loop(int socket)
     this->sock = socket;
 
     CircularCharBuffer *in_buffer = new CircularCharBuffer(RSP_PACKET_MAX_SIZE);
-    this->out_buffer = new CircularCharBuffer(RSP_PACKET_MAX_SIZE);
+    // Replies with binary data may be twice bigger than the packet size once escaped
+    this->out_buffer = new CircularCharBuffer(RSP_PACKET_MAX_SIZE * 2 + 16);
 
     // Packet codec
     this->codec = new RspPacketCodec();
@@ -153,23 +157,28 @@ bool Rsp::send(const char *data, size_t len)
 {
     std::unique_lock<std::mutex> lock(this->mutex);
 
-    this->top->trace.msg(vp::Trace::LEVEL_TRACE, "Sending message (text: \"%s\", size: %ld)\n", data, len);
+    this->top->trace.msg(vp::Trace::LEVEL_TRACE, "Sending message (text: \"%.*s\", size: %ld)\n", (int)len, data, len);
 
     // disabled run length encoding since GDB didn't seem to like it
     this->codec->encode(data, len, this->out_buffer, true);
 
-    void *buf;
-    size_t size;
+    // The packet may wrap around the end of the circular buffer, in which case it is sent in
+    // 2 parts
+    while (this->out_buffer->size() > 0)
+    {
+        void *buf;
+        size_t size;
 
-    this->out_buffer->read_block(&buf, &size);
+        this->out_buffer->read_block(&buf, &size);
 
-    if (::send(this->sock, buf, size, 0) != (int)size)
-    {
-        this->top->trace.msg(vp::Trace::LEVEL_INFO, "Unable to send data to client\n");
-        return false;
-    }
+        if (::send(this->sock, buf, size, 0) != (int)size)
+        {
+            this->top->trace.msg(vp::Trace::LEVEL_INFO, "Unable to send data to client\n");
+            return false;
+        }
 
-    this->out_buffer->commit_read(size);
+        this->out_buffer->commit_read(size);
+    }
 
     lock.unlock();
 
@@ -185,6 +194,11 @@ bool Rsp::send_str(const char *data)
 
 bool Rsp::signal_from_core(vp::Gdbserver_core *core, int signal, std::string reason, int info)
 {
+    if (this->stopping_cores)
+    {
+        return true;
+    }
+
     char str[128];
     int len;
     len = snprintf(str, 128, "T%02xthread:%x;", signal, core->gdbserver_get_id()+1);
@@ -199,7 +213,9 @@ bool Rsp::signal_from_core(vp::Gdbserver_core *core, int signal, std::string rea
         return false;
     }
 
+    this->stopping_cores = true;
     this->stop_all_cores_safe();
+    this->stopping_cores = false;
 
     return true;
 }
@@ -451,7 +467,7 @@ bool Rsp::query(char* data, size_t len)
 
     if (strncmp ("qSupported", data, strlen("qSupported")) == 0)
     {
-        snprintf(reply, REPLY_BUF_LEN, "PacketSize=%x;vContSupported+;hwbreak+;QNonStop-", RSP_PACKET_MAX_SIZE);
+        snprintf(reply, REPLY_BUF_LEN, "PacketSize=%x;vContSupported+;hwbreak+;binary-upload+;QNonStop-", RSP_PACKET_MAX_SIZE);
         return send_str(reply);
     }
     else if (strncmp ("qTStatus", data, strlen ("qTStatus")) == 0)
@@ -670,6 +686,9 @@ bool Rsp::decode(char* data, size_t len)
         case 'm':
             return this->mem_read(&data[1], len-1);
 
+        case 'x':
+            return this->mem_read_binary(&data[1], len-1);
+
         case 'z':
             return this->bp_remove(&data[0], len);
 
@@ -801,13 +820,10 @@ void Rsp::start(int port)
     }
 }
 
-bool Rsp::mem_read(char *data, size_t)
+bool Rsp::mem_read_common(char *data, std::vector<uint8_t> &buffer)
 {
-    unsigned char buffer[512];
-    char reply[1024];
     uint32_t addr;
     uint32_t length;
-    uint32_t i;
 
     if (sscanf(data, "%x,%x", &addr, &length) != 2)
     {
@@ -815,31 +831,54 @@ bool Rsp::mem_read(char *data, size_t)
         return false;
     }
 
-    if (length >= 512)
+    // The protocol allows returning less data than requested, gdb will then ask for the rest
+    if (length > RSP_MEM_READ_MAX_SIZE)
     {
-        return send_str("E01");
+        length = RSP_MEM_READ_MAX_SIZE;
     }
 
-    if (1) //m_top->target->check_mem_access(addr, length))
+    buffer.resize(length);
+
+    return this->top->io_access(addr, length, buffer.data(), false) == 0;
+}
+
+
+bool Rsp::mem_read(char *data, size_t)
+{
+    std::vector<uint8_t> buffer;
+
+    if (!this->mem_read_common(data, buffer))
     {
-        if (this->top->io_access(addr, length, (uint8_t *)buffer, false))
-        {
-            return send_str("E03");
-        }
+        return send_str("E03");
+    }
 
-        for (i = 0; i < length; i++)
-        {
-            snprintf(&reply[i * 2], 3, "%02x", (uint32_t)buffer[i]);
-        }
+    static const char hex[] = "0123456789abcdef";
+    std::vector<char> reply(buffer.size() * 2);
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        reply[i * 2] = hex[buffer[i] >> 4];
+        reply[i * 2 + 1] = hex[buffer[i] & 0xf];
     }
-    else
+
+    return send(reply.data(), reply.size());
+}
+
+
+bool Rsp::mem_read_binary(char *data, size_t)
+{
+    std::vector<uint8_t> buffer;
+
+    if (!this->mem_read_common(data, buffer))
     {
-        this->top->trace.msg(vp::Trace::LEVEL_ERROR, "Filtered memory read attempt - area is inaccessible\n");
-        memset(reply, (int)'0', length * 2);
-        reply[length * 2] = '\0';
+        return send_str("E03");
     }
 
-    return send(reply, length * 2);
+    // Binary data are escaped by the codec when the packet is encoded
+    std::vector<char> reply(buffer.size() + 1);
+    reply[0] = 'b';
+    memcpy(&reply[1], buffer.data(), buffer.size());
+
+    return send(reply.data(), reply.size());
 }
 
 
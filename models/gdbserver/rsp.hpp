@@ -23,6 +23,7 @@
 
 #include <thread>
 #include <mutex>
+#include <vector>
 #include "rsp-packet-codec.hpp"
 #include "gdbserver.hpp"
 
@@ -54,6 +55,8 @@ private:
     bool reg_read(char *data, size_t);
     bool reg_write(char *data, size_t);
     bool mem_read(char *data, size_t);
+    bool mem_read_binary(char *data, size_t);
+    bool mem_read_common(char *data, std::vector<uint8_t> &buffer);
     bool bp_insert(char *data, size_t len);
     bool bp_remove(char *data, size_t len);
     void stop();
@@ -71,6 +74,9 @@ private:
     std::mutex mutex;
     bool proxy_loop_stop;
     int client_socket;
+    // True while the other cores are stopped after a core reported a stop, their own stop
+    // replies are then dropped since gdb only expects one
+    bool stopping_cores = false;
 };
 
 #endif
\ No newline at end of file
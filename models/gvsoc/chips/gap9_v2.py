@@ -21,6 +21,7 @@
 
 
 import gvsoc.gvsoc
+import gvsoc.json_tools as js
 import runner.chips.gap9_v2
 import os
 from elftools.elf.elffile import *
@@ -33,6 +34,7 @@ class Runner(gv.gvsoc.Runner, runner.chips.gap9_v2.Runner):
 
         # Check if the binary contains special riscv fesvr tohost symbol for interations
         # between simulated code and testbench
+        js.add_loaded_file(args.binary)
         with open(args.binary, 'rb') as file:
             elffile = ELFFile(file)
             for section in elffile.iter_sections():
@@ -24,6 +24,20 @@ import configparser
 import collections
 
 
+# Paths of all the JSON files loaded so far, used to know on which files a generated
+# configuration depends
+loaded_files = set()
+
+
+def add_loaded_file(path):
+    """Declare that the generated configuration depends on the content of a file.
+
+    This must be called by generators reading files other than JSON files, like ELF binaries,
+    so that a cached configuration is regenerated when the file changes.
+    """
+    loaded_files.add(os.path.abspath(path))
+
+
 def argToInt(value):
 	""" Given a size or addresse of the type passed in args	(ie 512KB or 1MB) then return the value in bytes.
 	In case of neither KB or MB was specified, 0x prefix can be used.
@@ -116,6 +130,8 @@ def get_config_file(file_path, interpret=False, find=False, path=None, paths=Non
                 file_path, ":".join(paths)))
         file_path = new_file_path
 
+    loaded_files.add(os.path.abspath(file_path))
+
     with io.open(file_path, 'r', encoding='utf-8') as fd:
         config_dict = json.load(fd, object_pairs_hook=OrderedDict)
         return config_dict
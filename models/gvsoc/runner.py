@@ -38,6 +38,9 @@ import importlib
 import gvsoc.gvsoc_control
 import signal
 import traceback
+import hashlib
+import json
+import collections
 
 
 def gen_config(args, config, working_dir, runner, cosim_mode):
@@ -76,6 +79,21 @@ def gen_config(args, config, working_dir, runner, cosim_mode):
     if args.gtkwi:
         gvsoc_config.set('events/gtkw', True)
 
+    if args.traffic_profiler:
+        gvsoc_config.set('traffic_profiler/enabled', True)
+
+    if args.traffic_profiler_bin_size is not None:
+        gvsoc_config.set('traffic_profiler/bin_size', args.traffic_profiler_bin_size)
+
+    if args.host_perf:
+        gvsoc_config.set('host_perf/enabled', True)
+
+    if args.mem_heatmap:
+        gvsoc_config.set('mem_heatmap/enabled', True)
+
+    if args.mem_heatmap_block_size is not None:
+        gvsoc_config.set('mem_heatmap/block_size', args.mem_heatmap_block_size)
+
     debug_mode = gvsoc_config.get_bool('debug-mode') or \
         gvsoc_config.get_bool('traces/enabled') or \
         gvsoc_config.get_bool('events/enabled') or \
@@ -120,6 +138,66 @@ def dump_config(full_config, gvsoc_config_path):
         file.write(full_config.dump_to_string())
 
 
+def get_config_deps(args):
+    # The generated configuration depends on all the python generators, JSON files and binaries
+    # which were loaded while generating it
+    deps = {}
+    files = list(js.loaded_files)
+    if args.binary is not None:
+        files.append(os.path.abspath(args.binary))
+    if args.debug_binary is not None:
+        files += [os.path.abspath(binary) for binary in args.debug_binary]
+    for module in list(sys.modules.values()):
+        path = getattr(module, '__file__', None)
+        if path is not None:
+            files.append(os.path.abspath(path))
+
+    for path in files:
+        if os.path.exists(path):
+            deps[path] = os.path.getmtime(path)
+
+    return deps
+
+
+def get_config_cache_path(cache_dir, target, args, options, working_dir):
+    # The key covers everything which can change the generated configuration apart from the
+    # content of the files it depends on, which is checked when the cache is loaded
+    key = hashlib.sha256()
+    key.update(f'{type(target).__module__}.{type(target).__qualname__}'.encode())
+    key.update(repr(sorted(vars(args).items(), key=lambda item: item[0])).encode())
+    key.update(repr(options).encode())
+    key.update(os.path.abspath(working_dir).encode())
+    for env in ['GAPY_CONFIGS', 'BUILDER_CONFIGS_PATH', 'SDK_CONFIGS_PATH', 'PULP_CONFIGS_PATH']:
+        key.update(repr(os.environ.get(env)).encode())
+
+    return os.path.join(cache_dir, key.hexdigest() + '.json')
+
+
+def load_config_cache(path):
+    try:
+        with open(path, 'r') as file:
+            cache = json.load(file, object_pairs_hook=collections.OrderedDict)
+    except (OSError, ValueError):
+        return None
+
+    for dep, mtime in cache['deps'].items():
+        if not os.path.exists(dep) or os.path.getmtime(dep) != mtime:
+            return None
+
+    return js.import_config(cache['config'], interpret=False, gen=False)
+
+
+def store_config_cache(path, args, full_config):
+    cache = { 'deps': get_config_deps(args), 'config': full_config.get_dict() }
+
+    # Write to a temporary file and rename it so that concurrent runs never see a partial file
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    tmp_path = f'{path}.{os.getpid()}'
+    with open(tmp_path, 'w') as file:
+        json.dump(cache, file)
+    os.replace(tmp_path, path)
+
+
 class Runner():
 
     class ExpectLoopThread(threading.Thread):
@@ -168,6 +246,22 @@ class Runner():
                         "gtkw": False,
                     },
 
+                    "traffic_profiler": {
+                        "enabled": False,
+                        "bin_size": 1000000,
+                        "path": "traffic"
+                    },
+
+                    "host_perf": {
+                        "enabled": False
+                    },
+
+                    "mem_heatmap": {
+                        "enabled": False,
+                        "block_size": 64,
+                        "path": "heatmap"
+                    },
+
                     "include_dirs": args.install_dirs,
 
                     "runner_module": "gv.gvsoc",
@@ -229,6 +323,22 @@ class Runner():
 
         [args, _] = parser.parse_known_args()
 
+        # Generating the configuration means walking the whole python tree, which can dominate
+        # the time of short runs, so it is reused from a previous run with the same target,
+        # options and files when a cache directory is given. The tree itself is already built
+        # at this point, only the configuration generation is skipped.
+        # RTL cosimulation and gtkwave script generation have side effects and are not cached.
+        cache_path = None
+        self.full_config = None
+        if args.config_cache is not None and self.rtl_runner is None and not args.vcd:
+            cache_path = get_config_cache_path(args.config_cache, self.target, args, options,
+                gapy_target.get_working_dir())
+            self.full_config = load_config_cache(cache_path)
+
+        if self.full_config is not None:
+            self.gvsoc_config_path = 'gvsoc_config.json'
+            return
+
         self.full_config, self.gvsoc_config_path = gen_config(
             args, { 'target': self.target.get_config() }, gapy_target.get_working_dir(), self, cosim_mode)
 
@@ -238,6 +348,9 @@ class Runner():
 
         gvsoc_config = self.full_config.get('target/gvsoc')
 
+        if cache_path is not None and not gvsoc_config.get_bool('events/gen_gtkw'):
+            store_config_cache(cache_path, args, self.full_config)
+
         if gvsoc_config.get_bool('events/gen_gtkw'):
             path = os.path.join(gapy_target.get_working_dir(), 'view.gtkw')
 
@@ -358,20 +471,6 @@ class Runner():
         return False
 
 
-    def __gen_debug_info(self, full_config, gvsoc_config):
-        debug_binaries_config = full_config.get('**/debug_binaries')
-        if debug_binaries_config is not None:
-            binaries_config = full_config.get('**/binaries')
-            if binaries_config is not None:
-                binaries = binaries_config.get_dict()
-                for index, binary in enumerate(debug_binaries_config.get_dict()):
-                    # Only generate debug symbols for small binaries, otherwise it is too slow
-                    # To allow it, the ISS should itself read the symbols.
-                    if os.path.getsize(binaries[index]) < 5 * 1024*1024:
-                        if os.system('gen-debug-info %s %s' % (binaries[index], binary)) != 0:
-                            print('Error while generating debug symbols information, make sure the toolchain and the binaries are accessible ')
-
-
     def run(self, norun=False):
 
         args = self.gapy_target.get_args()
@@ -379,8 +478,6 @@ class Runner():
 
         dump_config(self.full_config, self.gapy_target.get_abspath(self.gvsoc_config_path))
 
-        self.__gen_debug_info(self.full_config, self.full_config.get('target/gvsoc'))
-
         if norun:
             return 0
 
@@ -582,6 +679,21 @@ class Target(gapy.Target):
             parser.add_argument("--gtkwi", dest="gtkwi", action="store_true",
                 help="Dump events to pipe and open gtkwave in interactive mode")
 
+            parser.add_argument("--traffic-profiler", dest="traffic_profiler", action="store_true",
+                help="Dump interconnect and memory traffic profiles to the traffic directory")
+
+            parser.add_argument("--traffic-profiler-bin-size", dest="traffic_profiler_bin_size",
+                default=None, type=int, help="Specify traffic profiler bin size in picoseconds")
+
+            parser.add_argument("--host-perf", dest="host_perf", action="store_true",
+                help="Report host performance counters for each simulation phase")
+
+            parser.add_argument("--mem-heatmap", dest="mem_heatmap", action="store_true",
+                help="Dump memory access heatmaps to the heatmap directory")
+
+            parser.add_argument("--mem-heatmap-block-size", dest="mem_heatmap_block_size",
+                default=None, type=int, help="Specify memory heatmap block size in bytes")
+
             parser.add_argument("--emulation", dest="emulation", action="store_true",
                 help="Launch in emulation mode")
 
@@ -628,6 +740,11 @@ class Target(gapy.Target):
             parser.add_argument("--control-script", dest="gvcontrol", default=None,
                 help="Specify gvcontrol script")
 
+            parser.add_argument("--config-cache", dest="config_cache",
+                default=os.environ.get('GVSOC_CONFIG_CACHE'),
+                help="Reuse the generated configuration from this directory when the target, "
+                "options and generator files did not change")
+
             [args, otherArgs] = parser.parse_known_args()
 
             if args.install_dirs is not None:
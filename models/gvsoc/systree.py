@@ -609,7 +609,10 @@ class Component(object):
             The resulting dictionary
         """
 
-        with open(self.get_file_path(path), 'r') as fd:
+        file_path = self.get_file_path(path)
+        js.loaded_files.add(os.path.abspath(file_path))
+
+        with open(file_path, 'r') as fd:
             return json.load(fd)
 
     def set_component(self, name):
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Occupancy of one bank behind the interleaver.
+ *
+ * A bank can only serve one access per cycle, so an access arriving while the bank is still
+ * busy with a previous one waits for the remaining busy time.
+ */
+class InterleaverBank
+{
+public:
+  // Reserve the bank for an access arriving at the specified cycle and lasting the specified
+  // number of cycles. Return the number of cycles the access must wait for the bank.
+  inline int64_t access(int64_t cycle, int64_t duration)
+  {
+    int64_t stalls = this->busy_until > cycle ? this->busy_until - cycle : 0;
+    this->busy_until = cycle + stalls + duration;
+    return stalls;
+  }
+
+  inline void reset() { this->busy_until = 0; }
+
+private:
+  // First cycle where the bank is free again
+  int64_t busy_until = 0;
+};
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2020 GreenWaves Technologies, SAS, ETH Zurich and
+ *                    University of Bologna
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Standalone check of the interleaver bank conflicts.
+ *
+ * It can be built and run from the repository root with:
+ *
+ *   g++ models/interco/interleaver_bank_check.cpp -o interleaver_bank_check
+ *   ./interleaver_bank_check
+ */
+
+#include <stdio.h>
+
+#include "interleaver_bank.hpp"
+
+
+static int check(const char *name, int64_t stalls, int64_t expected)
+{
+  if (stalls != expected)
+  {
+    fprintf(stderr, "%s: got %ld stall cycles, expected %ld\n", name, (long)stalls,
+      (long)expected);
+    return 1;
+  }
+  return 0;
+}
+
+
+int main()
+{
+  InterleaverBank banks[2];
+  int errors = 0;
+
+  // Two back-to-back accesses to the same bank in the same cycle, the second one waits for
+  // the first one
+  errors += check("first access", banks[0].access(10, 1), 0);
+  errors += check("conflicting access", banks[0].access(10, 1), 1);
+  // A third one waits for both
+  errors += check("second conflicting access", banks[0].access(10, 1), 2);
+
+  // Another bank is not impacted
+  errors += check("other bank", banks[1].access(10, 1), 0);
+
+  // Once the bank is free again, there is no stall
+  errors += check("access after busy time", banks[0].access(13, 1), 0);
+
+  // Longer accesses keep the bank busy for their whole duration
+  errors += check("long access", banks[1].access(20, 4), 0);
+  errors += check("access during long access", banks[1].access(22, 1), 2);
+
+  banks[0].reset();
+  errors += check("access after reset", banks[0].access(0, 1), 0);
+
+  printf("%s (errors: %d)\n", errors ? "FAILED" : "PASSED", errors);
+
+  return errors != 0;
+}
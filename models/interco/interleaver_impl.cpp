@@ -21,7 +21,9 @@
 
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
+#include <vp/traffic_profiler.hpp>
 #include <stdio.h>
+#include "interleaver_bank.hpp"
 #include <math.h>
 
 class interleaver : public vp::Component
@@ -31,6 +33,9 @@ public:
 
     interleaver(vp::ComponentConf &conf);
 
+  void reset(bool active);
+  void stop();
+
   static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
 
 
@@ -40,8 +45,10 @@ public:
 
 private:
   vp::Trace     trace;
+  vp::TrafficProfiler profiler;
 
   vp::IoMaster **out;
+  InterleaverBank *banks;
   vp::IoSlave **masters_in;
   vp::IoSlave in;
 
@@ -54,7 +61,7 @@ private:
 };
 
 interleaver::interleaver(vp::ComponentConf &config)
-: vp::Component(config)
+: vp::Component(config), profiler(*this)
 {
   traces.new_trace("trace", &trace, vp::DEBUG);
 
@@ -76,12 +83,15 @@ interleaver::interleaver(vp::ComponentConf &config)
   offset_mask &= ~((1 << (interleaving_bits + stage_bits)) - 1);
 
   out = new vp::IoMaster *[nb_slaves];
+  banks = new InterleaverBank[nb_slaves];
   for (int i=0; i<nb_slaves; i++)
   {
     out[i] = new vp::IoMaster();
     out[i]->set_resp_meth(&interleaver::response);
     out[i]->set_grant_meth(&interleaver::grant);
     new_master_port("out_" + std::to_string(i), out[i]);
+    // Channel identifiers are the output indexes
+    profiler.add_channel("out_" + std::to_string(i));
   }
 
   masters_in = new vp::IoSlave *[nb_masters];
@@ -131,10 +141,18 @@ vp::IoReqStatus interleaver::req(vp::Block *__this, vp::IoReq *req)
 
     if (!_this->out[output_id]) return vp::IO_REQ_INVALID;
 
+    // Accesses to a bank still busy with a previous access wait for it. Banks are not
+    // modeled without clock, as there is then no notion of cycle.
+    int64_t stalls = 0;
+    if (!req->is_debug() && _this->clock.get_engine())
+    {
+      stalls = _this->banks[output_id].access(_this->clock.get_cycles(), 1);
+    }
+
     req->set_addr(new_offset);
     req->set_size(loop_size);
     req->set_data(data);
-    req->set_latency(0);
+    req->set_latency(stalls);
 
     vp::IoReqStatus err = _this->out[output_id]->req_forward(req);
     if (err != vp::IO_REQ_OK)
@@ -152,6 +170,14 @@ vp::IoReqStatus interleaver::req(vp::Block *__this, vp::IoReq *req)
     }
     
     int64_t iter_latency = req->get_latency();
+
+    // Only the time waiting for the bank is accounted as stalls, the latency returned by the
+    // bank also includes its access time
+    if (_this->profiler.get_active() && !req->is_debug())
+    {
+      _this->profiler.account(output_id, is_write, loop_size, stalls);
+    }
+
     if (iter_latency > latency)
     {
       latency = iter_latency;
@@ -172,6 +198,22 @@ vp::IoReqStatus interleaver::req(vp::Block *__this, vp::IoReq *req)
   return vp::IO_REQ_OK;
 }
 
+void interleaver::reset(bool active)
+{
+  if (active)
+  {
+    for (int i=0; i<this->nb_slaves; i++)
+    {
+      this->banks[i].reset();
+    }
+  }
+}
+
+void interleaver::stop()
+{
+  this->profiler.dump();
+}
+
 void interleaver::grant(vp::Block *__this, vp::IoReq *req)
 {
 
@@ -23,6 +23,7 @@
 #include <vp/itf/io.hpp>
 #include <vp/itf/wire.hpp>
 #include <vp/proxy.hpp>
+#include <vp/traffic_profiler.hpp>
 #include <stdio.h>
 #include <math.h>
 
@@ -63,6 +64,7 @@ public:
   string target_name;
   MapEntry *next = NULL;
   int id = -1;
+  int profiler_id = -1;
   unsigned long long base = 0;
   unsigned long long lowestBase = 0;
   unsigned long long size = 0;
@@ -93,6 +95,8 @@ public:
 
   router(vp::ComponentConf &conf);
 
+  void stop();
+
   std::string handle_command(gv::GvProxy *proxy, FILE *req_file, FILE *reply_file, std::vector<std::string> args, std::string req);
 
   static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
@@ -104,6 +108,7 @@ public:
 
 private:
   vp::Trace     trace;
+  vp::TrafficProfiler profiler;
 
   io_master_map out;
   vp::IoSlave in;
@@ -124,7 +129,7 @@ private:
 };
 
 router::router(vp::ComponentConf &config)
-: vp::Component(config)
+: vp::Component(config), profiler(*this)
 {
   traces.new_trace("trace", &trace, vp::DEBUG);
 
@@ -216,6 +221,14 @@ void MapEntry::insert(router *router)
 {
   lowestBase = base;
 
+  if (router->profiler.get_active())
+  {
+    // Entries bound by the python generator do not have a name, use their base instead
+    char name[32];
+    snprintf(name, sizeof(name), "0x%llx", base);
+    profiler_id = router->profiler.add_channel(target_name != "" ? target_name : name);
+  }
+
   if (size != 0) {
     if (port != NULL || itf != NULL) {    
       MapEntry *current = router->firstMapEntry;
@@ -301,6 +314,8 @@ vp::IoReqStatus router::req(vp::Block *__this, vp::IoReq *req)
       _this->trace.msg(vp::Trace::LEVEL_TRACE, "Routing to entry (target: %s)\n", entry->target_name.c_str());
     }
     
+    int64_t stalls = 0;
+
     if (!req->is_debug())
     {
       if (_this->bandwidth != 0)
@@ -320,6 +335,7 @@ vp::IoReqStatus router::req(vp::Block *__this, vp::IoReq *req)
         int64_t router_latency = *next_packet_time - _this->clock.get_cycles();
         if (router_latency > latency)
         {
+          stalls = router_latency - latency;
           latency = router_latency;
         }
 
@@ -375,6 +391,11 @@ vp::IoReqStatus router::req(vp::Block *__this, vp::IoReq *req)
         req->arg_pop();
     }
 
+    if (_this->profiler.get_active() && !req->is_debug())
+    {
+      _this->profiler.account(entry->profiler_id, !isRead, iter_size, stalls);
+    }
+
     if (entry->id != -1) 
     {
       int64_t latency = req->get_latency();
@@ -410,6 +431,11 @@ vp::IoReqStatus router::req(vp::Block *__this, vp::IoReq *req)
   return result;
 }
 
+void router::stop()
+{
+  this->profiler.dump();
+}
+
 void router::grant(vp::Block *__this, vp::IoReq *req)
 {
   router *_this = (router *)__this;
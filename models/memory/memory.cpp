@@ -22,6 +22,8 @@
 #include <vp/vp.hpp>
 #include <vp/itf/io.hpp>
 #include <vp/itf/wire.hpp>
+#include <vp/traffic_profiler.hpp>
+#include <vp/mem_heatmap.hpp>
 #include <stdio.h>
 #include <string.h>
 
@@ -33,6 +35,7 @@ public:
     Memory(vp::ComponentConf &config);
 
     void reset(bool active);
+    void stop();
 
     static vp::IoReqStatus req(vp::Block *__this, vp::IoReq *req);
 
@@ -47,6 +50,8 @@ private:
 
     vp::Trace trace;
     vp::IoSlave in;
+    vp::TrafficProfiler profiler;
+    vp::MemHeatmap heatmap;
 
     uint64_t size = 0;
     bool check = false;
@@ -82,12 +87,14 @@ private:
 
 
 Memory::Memory(vp::ComponentConf &config)
-    : vp::Component(config)
+    : vp::Component(config), profiler(*this), heatmap(*this)
 {
     traces.new_trace("trace", &trace, vp::DEBUG);
     in.set_req_meth(&Memory::req);
     new_slave_port("input", &in);
 
+    this->profiler.add_channel("input");
+
     this->power_ctrl_itf.set_sync_meth(&Memory::power_ctrl_sync);
     new_slave_port("power_ctrl", &this->power_ctrl_itf);
 
@@ -114,6 +121,8 @@ Memory::Memory(vp::ComponentConf &config)
 
     trace.msg("Building Memory (size: 0x%x, check: %d)\n", size, check);
 
+    this->heatmap.init(0, this->size);
+
     if (align)
     {
         mem_data = (uint8_t *)aligned_alloc(align, size);
@@ -184,6 +193,8 @@ vp::IoReqStatus Memory::req(vp::Block *__this, vp::IoReq *req)
 
     req->inc_latency(_this->latency);
 
+    int64_t stalls = 0;
+
     // Impact the Memory bandwith on the packet
     if (_this->width_bits != 0)
     {
@@ -196,10 +207,21 @@ vp::IoReqStatus Memory::req(vp::Block *__this, vp::IoReq *req)
         {
             _this->trace.msg("Delayed packet (latency: %ld)\n", diff);
             req->inc_latency(diff);
+            stalls = diff;
         }
         _this->next_packet_start = MAX(_this->next_packet_start, cycles) + duration;
     }
 
+    if (_this->profiler.get_active() && !req->is_debug())
+    {
+        _this->profiler.account(0, req->get_is_write(), size, stalls);
+    }
+
+    if (_this->heatmap.get_active() && !req->is_debug() && offset + size <= _this->size)
+    {
+        _this->heatmap.account(offset, size, req->get_is_write());
+    }
+
     if (_this->power.get_power_trace()->get_active())
     {
         _this->last_access_timestamp = _this->time.get_time();
@@ -429,6 +451,14 @@ void Memory::reset(bool active)
 
 
 
+void Memory::stop()
+{
+    this->profiler.dump();
+    this->heatmap.dump();
+}
+
+
+
 void Memory::power_ctrl_sync(vp::Block *__this, bool value)
 {
     Memory *_this = (Memory *)__this;
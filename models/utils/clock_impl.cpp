@@ -24,6 +24,9 @@
 #include <stdio.h>
 #include <string.h>
 
+// Number of frequency steps used to ramp the clock up when it is powered on
+#define CLOCK_POWERUP_STEPS 16
+
 class Clock : public vp::Component
 {
 
@@ -34,49 +37,140 @@ public:
 
 private:
     static void edge_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void powerup_handler(vp::Block *__this, vp::ClockEvent *event);
     inline void raise_edge();
     static void power_sync(vp::Block *__this, bool active);
+    void signal_update(float frequency);
+    void clock_start();
+    void clock_stop();
 
     vp::Trace trace;
     vp::WireSlave<bool> power_itf;
     vp::ClockMaster clock_ctrl_itf;
     vp::ClockMaster clock_sync_itf;
     vp::ClockEvent *event;
+    // Event used for applying the power-up ramp, one step at a time
+    vp::ClockEvent *powerup_event;
+    vp::ClockSignal signal;
     int value;
     float target_frequency;
     float frequency;
     float powerup_time;
     bool powered_on;
     int64_t start_time;
+    int powerup_step;
 };
 
 inline void Clock::raise_edge()
 {
     this->trace.msg(vp::Trace::LEVEL_TRACE, "Changing clock level (level: %d)\n", value);
 
-    if (this->target_frequency)
+    this->clock_sync_itf.sync(value);
+    this->value ^= 1;
+}
+
+void Clock::edge_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    Clock *_this = (Clock *)__this;
+    _this->raise_edge();
+}
+
+
+void Clock::signal_update(float frequency)
+{
+    // The clock level is toggled on each cycle of our own clock domain, starting with a low
+    // level, so the first rising edge happens after 2 cycles.
+    int64_t half_period = frequency > 0 ? (int64_t)(1e12 / frequency) : 0;
+
+    this->signal.period = half_period * 2;
+    this->signal.phase = half_period * 2;
+    this->signal.duty = 50;
+    this->signal.start_time = this->time.get_time();
+
+    this->trace.msg(vp::Trace::LEVEL_DEBUG, "Updating clock signal (period: %ld, start_time: %ld)\n",
+        this->signal.period, this->signal.start_time);
+
+    this->clock_sync_itf.set_signal(&this->signal);
+}
+
+
+void Clock::powerup_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    Clock *_this = (Clock *)__this;
+    float frequency;
+
+    _this->powerup_step++;
+
+    if (_this->powerup_step >= CLOCK_POWERUP_STEPS)
+    {
+        frequency = _this->target_frequency;
+        _this->target_frequency = 0;
+    }
+    else
+    {
+        frequency = _this->target_frequency *
+            (0.1 + 0.9 * _this->powerup_step / CLOCK_POWERUP_STEPS);
+    }
+
+    _this->trace.msg(vp::Trace::LEVEL_DEBUG, "Applying power-up step (step: %d, frequency: %f)\n",
+        _this->powerup_step, frequency);
+
+    _this->clock_ctrl_itf.set_frequency(frequency);
+    _this->signal_update(frequency);
+
+    if (_this->target_frequency)
+    {
+        // Steps are specified in time, while the event is specified in cycles of the frequency
+        // we just applied.
+        int64_t cycles = _this->powerup_time / CLOCK_POWERUP_STEPS * frequency / 1e12;
+        _this->event_enqueue(_this->powerup_event, cycles > 0 ? cycles : 1);
+    }
+}
+
+
+void Clock::clock_start()
+{
+    if (this->clock_sync_itf.is_bound())
     {
-        int64_t diff_time = this->time.get_time()- this->start_time;
-        if (diff_time >= this->powerup_time)
+        // Edges are only generated if a bound slave registered a sync method. Slaves keeping the
+        // default sync method, like clock domains which only take the frequency, get none.
+        // No in-tree slave registers set_signal yet, the description is there for external
+        // models which can compute the edges on demand.
+        if (this->clock_sync_itf.needs_edges() && !this->event->is_enqueued())
         {
-            this->clock_ctrl_itf.set_frequency(this->target_frequency);
-            this->target_frequency = 0;
+            this->event->enable();
+        }
+
+        if (this->target_frequency && this->powerup_time > 0)
+        {
+            this->powerup_step = 0;
+            this->clock_ctrl_itf.set_frequency(this->target_frequency * 0.1);
+            this->signal_update(this->target_frequency * 0.1);
+            int64_t cycles = this->powerup_time / CLOCK_POWERUP_STEPS * this->target_frequency * 0.1 / 1e12;
+            this->event_enqueue(this->powerup_event, cycles > 0 ? cycles : 1);
         }
         else
         {
-            float frequency = this->target_frequency * (0.1 + 0.9 * diff_time / this->powerup_time);
-            this->clock_ctrl_itf.set_frequency(frequency);
+            this->target_frequency = 0;
+            this->signal_update(this->frequency);
         }
     }
-
-    this->clock_sync_itf.sync(value);
-    this->value ^= 1;
 }
 
-void Clock::edge_handler(vp::Block *__this, vp::ClockEvent *event)
+
+void Clock::clock_stop()
 {
-    Clock *_this = (Clock *)__this;
-    _this->raise_edge();
+    if (this->event->is_enqueued())
+    {
+        this->event->disable();
+    }
+    if (this->powerup_event->is_enqueued())
+    {
+        this->event_cancel(this->powerup_event);
+    }
+
+    this->target_frequency = 0;
+    this->signal_update(0);
 }
 
 
@@ -92,17 +186,11 @@ void Clock::power_sync(vp::Block *__this, bool active)
         {
             _this->target_frequency = _this->frequency;
             _this->start_time = _this->time.get_time();
-            if (_this->clock_sync_itf.is_bound())
-            {
-                _this->event->enable();
-            }
+            _this->clock_start();
         }
         else
         {
-            if (_this->event->is_enqueued())
-            {
-                _this->event->disable();
-            }
+            _this->clock_stop();
         }
     }
 
@@ -115,12 +203,14 @@ Clock::Clock(vp::ComponentConf &config)
 {
     traces.new_trace("trace", &trace, vp::DEBUG);
     this->event = this->event_new(Clock::edge_handler);
+    this->powerup_event = this->event_new(Clock::powerup_handler);
 
     this->power_itf.set_sync_meth(&Clock::power_sync);
     this->new_slave_port("power", &this->power_itf);
     this->new_master_port("clock_ctrl", &this->clock_ctrl_itf);
     this->new_master_port("clock_sync", &this->clock_sync_itf);
     this->value = 0;
+    this->powerup_step = 0;
     this->powerup_time = this->get_js_config()->get_child_int("powerup_time");
     this->powered_on = this->get_js_config()->get("powered_on") == NULL || this->get_js_config()->get_child_bool("powered_on");
 
@@ -136,13 +226,7 @@ void Clock::reset(bool active)
 
         if (this->powered_on)
         {
-            if (!this->event->is_enqueued())
-            {
-                if (this->clock_sync_itf.is_bound())
-                {
-                    this->event->enable();
-                }
-            }
+            this->clock_start();
         }
     }
 }